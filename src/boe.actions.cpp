@@ -30,6 +30,8 @@
 #include "dialog.hpp"
 #include "scrollbar.hpp"
 #include "boe.menus.hpp"
+#include "boe.replay.hpp"
+#include "boe.timers.hpp"
 #include "winutil.hpp"
 #include "cursors.hpp"
 #include "spell.hpp"
@@ -84,7 +86,7 @@ extern short cen_x, cen_y, stat_window;//,pc_moves[6];
 extern eGameMode overall_mode;
 extern location	to_create;
 extern bool All_Done,spell_forced,monsters_going;
-extern bool party_in_memory;
+extern bool party_in_memory,headless;
 
 // game info globals
 extern sf::RenderWindow mainPtr;
@@ -121,7 +123,6 @@ short wand_loc_count = 0;
 short monst_place_count = 0; // 1 - standard place	2 - place last
 
 rectangle shopping_rects[8][7];
-std::queue<pending_special_type> special_queue;
 bool end_scenario = false;
 bool current_bash_is_bash = false;
 
@@ -129,7 +130,7 @@ bool current_bash_is_bash = false;
 extern void edit_stuff_done();
 
 void init_screen_locs() {
-	short i,j,k,l;
+	short i,j;
 	rectangle startup_base = {279,5,327,306};
 	rectangle shop_base = {63,12,99,267};
 	
@@ -164,15 +165,8 @@ void init_screen_locs() {
 	startup_top.left = 5;
 	startup_top.right = startup_button[STARTBTN_JOIN].right;
 	
-	for(i = 0; i < 200; i++)
-		for(j = 0; j < 8; j++)
-			for(k = 0; k < 64; k++)////
-				univ.town_maps[i][j][k] = 0;
-	
-	for(i = 0; i < 100; i++)
-		for(k = 0; k < 6; k++)
-			for(l = 0; l < 48; l++)
-				univ.out_maps[i][k][l] = 0;
+	univ.town_maps.clear();
+	univ.out_maps.clear();
 	
 	// name, use, give, drip, info, sell/id   each one 13 down
 	item_buttons[0][ITEMBTN_NAME].top = 17;
@@ -850,6 +844,8 @@ static void handle_town_wait(bool& need_redraw, bool& need_reprint) {
 	put_pc_screen();
 }
 
+static void finish_specials(short redraw);
+
 static void handle_combat_switch(bool& did_something, bool& need_redraw, bool& need_reprint) {
 	if(overall_mode == MODE_TOWN) {
 		if(univ.party.in_boat >= 0) {
@@ -872,9 +868,12 @@ static void handle_combat_switch(bool& did_something, bool& need_redraw, bool& n
 		if(which_combat_type == 0) {
 			if(hit_end_c_button()) {
 				end_town_mode(0,univ.town.p_loc);
-				play_sound(93);
 				add_string_to_buf("End combat.");
-				handle_wandering_specials(0,1);
+				// The victory special waits until the fanfare is over
+				play_sound(93, eSndPriority::NORMAL, []() {
+					handle_wandering_specials(0,1);
+					finish_specials(1);
+				});
 				menu_activate();
 				put_pc_screen();
 				set_stat_window(current_pc);
@@ -950,6 +949,9 @@ static void handle_victory() {
 	}
 }
 
+// Set while the death sound plays, so that the party only dies once
+static bool death_pending = false;
+
 static void handle_party_death() {
 	for(int i = 0; i < 6; i++)
 		if(univ.party[i].main_status == eMainStatus::FLED)
@@ -976,13 +978,29 @@ static void handle_party_death() {
 	draw_terrain();
 	put_pc_screen();
 	put_item_screen(stat_window);
-	if(!univ.party.is_alive()) {
-		play_sound(13);
-		handle_death();
+	if(!univ.party.is_alive() && !death_pending) {
+		death_pending = true;
+		play_sound(13, eSndPriority::NORMAL, []() {
+			death_pending = false;
+			handle_death();
+		});
 	}
 }
 
+// Brings the screen up to date after specials that ran outside of an action
+static void finish_specials(short redraw) {
+	if(redraw > 0) draw_terrain();
+	put_pc_screen();
+	put_item_screen(stat_window);
+	print_buf();
+	if(!univ.party.is_alive())
+		handle_party_death();
+	else if(end_scenario)
+		handle_victory();
+}
+
 bool handle_action(sf::Event event) {
+	cSubsystemTimer timer(eSubsystem::ACTIONS);
 	short s1,s2,s3;
 	long item_hit;
 	bool are_done = false;
@@ -1423,14 +1441,9 @@ bool handle_action(sf::Event event) {
 	}
  	
  	// MARK: At this point, see if any specials have been queued up, and deal with them
-	// Note: We just check once here instead of looping because run_special also pulls from the queue.
-	if(!special_queue.empty()) {
-		s3 = 0;
-		pending_special_type pending = special_queue.front();
-		special_queue.pop();
-		run_special(pending, &s1, &s2, &s3);
-		if(s3 > 0) need_redraw = true;
-	}
+	s3 = 0;
+	run_queued_specials(&s1, &s2, &s3);
+	if(s3 > 0) need_redraw = true;
 	
 	// MARK: Handle non-PC stuff (like monsters) if the party actually did something
 	if(did_something) handle_monster_actions(need_redraw, need_reprint);
@@ -1456,6 +1469,13 @@ bool handle_action(sf::Event event) {
 	return are_done;
 }
 
+// Carries on with a chain of specials that was too long to finish in one frame.
+void handle_paused_specials() {
+	short s1 = 0, s2 = 0, s3 = 0;
+	run_queued_specials(&s1, &s2, &s3);
+	finish_specials(s3);
+}
+
 void handle_monster_actions(bool& need_redraw, bool& need_reprint) {
 	draw_map(true);
 	play_ambient_sound();
@@ -1524,6 +1544,7 @@ bool someone_awake() {
 
 void handle_menu_spell(eSpell spell_picked) {
 	eSkill spell_type = (*spell_picked).type;
+	record_spell_menu(spell_picked);
 	if(!prime_time()) {
 		ASB("Finish what you're doing first.");
 		print_buf();
@@ -2020,7 +2041,8 @@ bool handle_keystroke(sf::Event& event){
 			ASB("Debug: Increase age.");
 			ASB("  It is now 1 day later.");
 			print_buf();
-			univ.party.age += 3700;
+			univ.party.shift_age(3700);
+			reset_timers();
 			put_pc_screen();
 			break;
 		case '>':
@@ -3193,6 +3215,7 @@ bool is_sign(ter_num_t ter) {
 bool check_for_interrupt(){
 	using kb = sf::Keyboard;
 	bool interrupt = false;
+	if(headless) return false;
 #ifdef __APPLE__
 	if((kb::isKeyPressed(kb::LSystem) || kb::isKeyPressed(kb::RSystem)) && kb::isKeyPressed(kb::Period))
 		interrupt = true;
@@ -19,8 +19,10 @@
 #include "boe.graphutil.hpp"
 #include "boe.main.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "choicedlog.hpp"
 #include "boe.menus.hpp"
+#include "boe.replay.hpp"
 #include "spell.hpp"
 #include "prefs.hpp"
 
@@ -30,7 +32,7 @@ extern short stat_window;
 extern location center;
 extern short current_pc;
 extern short combat_active_pc;
-extern bool monsters_going,spell_forced;
+extern bool monsters_going,spell_forced,headless;
 extern bool flushingInput;
 extern sf::RenderWindow mainPtr;
 extern eSpell store_mage, store_priest;
@@ -272,10 +274,7 @@ void start_outdoor_combat(cOutdoors::cCreature encounter,location where,short nu
 	
 	// Basically, in outdoor combat, we create kind of a 48x48 town for
 	// the combat to take place in
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 48; j++) {
-			univ.town.fields[i][j] = 0;
-		}
+	univ.town.clear_fields();
 	univ.town.prep_arena();
 	univ.town->in_town_rect = town_rect;
 	
@@ -2224,6 +2223,7 @@ void combat_run_monst() {
 }
 
 void do_monster_turn() {
+	cSubsystemTimer timer(eSubsystem::MONSTERS);
 	bool acted_yet, had_monst = false,printed_poison = false,printed_disease = false,printed_acid = false;
 	bool redraw_not_yet_done = true;
 	bool special_called = false;
@@ -2400,7 +2400,7 @@ void do_monster_turn() {
 					current_monst_tactic = 1; // this means flee
 				
 				
-				if(cur_monst->abil[eMonstAbil::MISSILE].active && // Archer?
+				if((cur_monst->turn_plan & PLAN_ARCHER) && cur_monst->abil.has(eMonstAbil::MISSILE) && // Archer?
 					(dist(cur_monst->cur_loc,targ_space) < 6) &&
 					!monst_adjacent(targ_space,i))
 					current_monst_tactic = 1; // this means flee
@@ -2429,7 +2429,7 @@ void do_monster_turn() {
 				&& (can_see_monst(targ_space,i))) { // Begin spec. attacks
 				
 				// Basic breath weapons
-				if(cur_monst->abil[eMonstAbil::DAMAGE2].active && cur_monst->abil[eMonstAbil::DAMAGE2].gen.type == eMonstGen::BREATH
+				if((cur_monst->turn_plan & PLAN_BREATH) && cur_monst->abil.has(eMonstAbil::DAMAGE2) && cur_monst->abil[eMonstAbil::DAMAGE2].gen.type == eMonstGen::BREATH
 					&& !acted_yet && get_ran(1,1,1000) < cur_monst->abil[eMonstAbil::DAMAGE2].gen.odds) {
 					if(target != 6  && dist(cur_monst->cur_loc,targ_space) <= cur_monst->abil[eMonstAbil::DAMAGE2].gen.range) {
 						acted_yet = monst_breathe(cur_monst,targ_space,cur_monst->abil[eMonstAbil::DAMAGE2]);
@@ -2463,9 +2463,10 @@ void do_monster_turn() {
 				
 				// Missile (except basic breath weapons)
 				std::pair<eMonstAbil, uAbility> pick_abil;
-				if(!acted_yet) {
+				if(!acted_yet && (cur_monst->turn_plan & PLAN_RANGED)) {
 					// Go through all the monster's abilities and try to select one that's useable at this time
 					for(auto& abil : cur_monst->abil) {
+						if(!abil.second.active) continue;
 						switch(abil.first) {
 							case eMonstAbil::MISSILE:
 								if(dist(cur_monst->cur_loc, targ_space) > abil.second.missile.range)
@@ -2522,7 +2523,7 @@ void do_monster_turn() {
 				}
 				
 				// Unusual ability - don't use multiple times per round
-				if(cur_monst->abil[eMonstAbil::SPECIAL].active && !special_called && party_can_see_monst(i) && get_ran(1,1,1000) <= cur_monst->abil[eMonstAbil::SPECIAL].special.extra3) {
+				if((cur_monst->turn_plan & PLAN_SPECIAL) && cur_monst->abil.has(eMonstAbil::SPECIAL) && !special_called && party_can_see_monst(i) && get_ran(1,1,1000) <= cur_monst->abil[eMonstAbil::SPECIAL].special.extra3) {
 					uAbility abil = cur_monst->abil[eMonstAbil::SPECIAL];
 					short s1, s2, s3;
 					special_called = true;
@@ -2625,7 +2626,7 @@ void do_monster_turn() {
 			
 			// Place fields for monsters that create them. Only done when monst sees foe
 			if(target != 6 && can_see_light(cur_monst->cur_loc,targ_space,sight_obscurity) < 5) {
-				if(cur_monst->abil[eMonstAbil::RADIATE].active && get_ran(1,1,100) < cur_monst->abil[eMonstAbil::RADIATE].radiate.chance) {
+				if((cur_monst->turn_plan & PLAN_RADIATE) && cur_monst->abil.has(eMonstAbil::RADIATE) && get_ran(1,1,100) < cur_monst->abil[eMonstAbil::RADIATE].radiate.chance) {
 					switch(cur_monst->abil[eMonstAbil::RADIATE].radiate.pat) {
 						case PAT_SINGLE:
 							place_spell_pattern(single, cur_monst->cur_loc, cur_monst->abil[eMonstAbil::RADIATE].radiate.type, 7);
@@ -2654,7 +2655,7 @@ void do_monster_turn() {
 							break;
 					}
 				}
-				if(cur_monst->abil[eMonstAbil::SUMMON].active && get_ran(1,1,100) < cur_monst->abil[eMonstAbil::SUMMON].summon.chance) {
+				if((cur_monst->turn_plan & PLAN_SUMMON) && cur_monst->abil.has(eMonstAbil::SUMMON) && get_ran(1,1,100) < cur_monst->abil[eMonstAbil::SUMMON].summon.chance) {
 					uAbility abil = cur_monst->abil[eMonstAbil::SUMMON];
 					mon_num_t what_summon = 0;
 					switch(abil.summon.type) {
@@ -2713,7 +2714,8 @@ void do_monster_turn() {
 		
 		if((cur_monst->active < 0) || (cur_monst->active > 2))
 			cur_monst->active = 0; // clean up
-		if(cur_monst->active != 0) { // Take care of monster effects
+		// Most monsters have no status effects at all, so don't bother ticking them
+		if(cur_monst->active != 0 && cur_monst->status.any()) { // Take care of monster effects
 			if(cur_monst->status[eStatus::ACID] > 0) {  // Acid
 				if(!printed_acid) {
 					add_string_to_buf("Acid:");
@@ -2764,7 +2766,8 @@ void do_monster_turn() {
 				}
 				
 			}
-			
+		}
+		if(cur_monst->active != 0) {
 			if(univ.party.age % 4 == 0) {
 				cur_monst->restore_sp(2);
 				move_to_zero(cur_monst->status[eStatus::DUMB]);
@@ -2903,7 +2906,10 @@ void monster_attack(short who_att,iLiving* target) {
 						move_to_zero(attacker->status[eStatus::POISONED_WEAPON]);
 					}
 					
-					for(auto& abil : attacker->abil) {
+					// Most monsters have no touch abilities at all, so only look for them if the plan says so
+					static const cMonstAbilities no_abils;
+					const cMonstAbilities& touch_abils = (attacker->turn_plan & PLAN_TOUCH) ? attacker->abil : no_abils;
+					for(auto& abil : touch_abils) {
 						if(!abil.second.active) continue;
 						if(getMonstAbilCategory(abil.first) != eMonstAbilCat::GENERAL)
 							continue;
@@ -3005,7 +3011,8 @@ void monster_attack(short who_att,iLiving* target) {
 				play_sound(2);
 			}
 			redraw_screen(REFRESH_STATS | REFRESH_TERRAIN | REFRESH_TRANS);
-			sf::sleep(time_in_ticks(2));
+			if(!headless)
+				sf::sleep(time_in_ticks(2));
 			combat_posing_monster = -1;
 			draw_terrain(2);
 			combat_posing_monster = 100 + who_att;
@@ -3392,6 +3399,88 @@ bool monst_breathe(cCreature *caster,location targ_space,uAbility abil) {
 	return true;
 }
 
+// The levels of every creature in town, summed per space, with friendly creatures and the party counting
+// positive and hostile creatures negative. It's kept as a summed-area table, so the total over any square
+// (which is what a radius means under vdist) is four lookups rather than a scan over every creature.
+struct influence_map_t {
+	short dim;
+	// sums[x][y] is the total over all spaces (i,j) with i < x and j < y
+	int sums[65][65];
+};
+
+static void build_influence_map(influence_map_t& influence) {
+	int weight[64][64] = {};
+	influence.dim = univ.town->max_dim();
+	for(int i = 0; i < univ.town.monst.size(); i++) {
+		const cCreature& monst = univ.town.monst[i];
+		if(monst.active == 0) continue;
+		if(monst.cur_loc.x < 0 || monst.cur_loc.y < 0 || monst.cur_loc.x >= influence.dim || monst.cur_loc.y >= influence.dim)
+			continue;
+		weight[monst.cur_loc.x][monst.cur_loc.y] += monst.is_friendly() ? monst.level : -monst.level;
+	}
+	if(is_combat()) {
+		for(int i = 0; i < 6; i++) {
+			location pos = univ.party[i].combat_pos;
+			if(univ.party[i].main_status != eMainStatus::ALIVE) continue;
+			if(pos.x < 0 || pos.y < 0 || pos.x >= influence.dim || pos.y >= influence.dim)
+				continue;
+			weight[pos.x][pos.y] += 10;
+		}
+	}
+	for(int x = 0; x <= influence.dim; x++)
+		influence.sums[x][0] = 0;
+	for(int y = 0; y <= influence.dim; y++)
+		influence.sums[0][y] = 0;
+	for(int x = 1; x <= influence.dim; x++)
+		for(int y = 1; y <= influence.dim; y++)
+			influence.sums[x][y] = weight[x - 1][y - 1] + influence.sums[x - 1][y]
+				+ influence.sums[x][y - 1] - influence.sums[x - 1][y - 1];
+}
+
+static short count_levels(const influence_map_t& influence, location where, short radius) {
+	short store = 0;
+	int left = max(where.x - radius, 0), right = min(where.x + radius, influence.dim - 1);
+	int top = max(where.y - radius, 0), bottom = min(where.y + radius, influence.dim - 1);
+	if(left <= right && top <= bottom)
+		store = influence.sums[right + 1][bottom + 1] - influence.sums[left][bottom + 1]
+			- influence.sums[right + 1][top] + influence.sums[left][top];
+	// The party's weight in town depends on line of sight, so it can't go in the table.
+	if(is_town())
+		if(vdist(where,univ.town.p_loc) <= radius && can_see(where,univ.town.p_loc,sight_obscurity) < 5)
+			store += 20;
+	return store;
+}
+
+// mode: 0 - hostile casting  1 - friendly casting
+static location find_fireball_loc(const influence_map_t& influence, location where, short radius, short mode, short *m) {
+	location check_loc,cast_loc(120,0);
+	short cur_lev,level_max = 10;
+	
+	// Only spaces within 8 of the caster can be picked, so there's no need to look further.
+	short min_x = max(1, where.x - 8), max_x = min(univ.town->max_dim() - 2, where.x + 8);
+	short min_y = max(1, where.y - 8), max_y = min(univ.town->max_dim() - 2, where.y + 8);
+	for(check_loc.x = min_x; check_loc.x <= max_x; check_loc.x++)
+		for(check_loc.y = min_y; check_loc.y <= max_y; check_loc.y++) {
+			if(dist(where,check_loc) > 8 || dist(where,check_loc) <= radius)
+				continue;
+			cur_lev = count_levels(influence, check_loc, radius);
+			if(mode == 1)
+				cur_lev = cur_lev * -1;
+			// A space that can't at least tie isn't worth the line of sight checks.
+			if(cur_lev < level_max)
+				continue;
+			if(can_see(where,check_loc,sight_obscurity) < 5 && sight_obscurity(check_loc.x,check_loc.y) < 5) {
+				if((cur_lev > level_max) || (get_ran(1,0,1) == 0)) {
+					level_max = cur_lev;
+					cast_loc = check_loc;
+				}
+			}
+		}
+	*m = level_max;
+	
+	return cast_loc;
+}
+
 bool monst_cast_mage(cCreature *caster,short targ) {
 	short r1,j,i,level,target_levels,friend_levels_near,x;
 	bool acted = false;
@@ -3464,8 +3553,12 @@ bool monst_cast_mage(cCreature *caster,short targ) {
 	
 	level = minmax(1,7,caster->mu - caster->status[eStatus::DUMB]) - 1;
 	
-	target = find_fireball_loc(caster->cur_loc,1,caster->is_friendly(),&target_levels);
-	friend_levels_near = caster->is_friendly() ? count_levels(caster->cur_loc,3) : -1 * count_levels(caster->cur_loc,3);
+	influence_map_t influence;
+	build_influence_map(influence);
+	target = find_fireball_loc(influence,caster->cur_loc,1,caster->is_friendly(),&target_levels);
+	friend_levels_near = count_levels(influence,caster->cur_loc,3);
+	if(!caster->is_friendly())
+		friend_levels_near *= -1;
 	
 	if((caster->health * 4 < caster->m_health) && (get_ran(1,0,10) < 9))
 		spell = emer_spells[level][3];
@@ -3515,7 +3608,7 @@ bool monst_cast_mage(cCreature *caster,short targ) {
 	// How about shockwave? Good idea?
 	if(spell == eSpell::SHOCKWAVE && caster->is_friendly())
 		spell = eSpell::SUMMON_MAJOR;
-	if(spell == eSpell::SHOCKWAVE && !caster->is_friendly() && count_levels(caster->cur_loc,10) < 45)
+	if(spell == eSpell::SHOCKWAVE && !caster->is_friendly() && count_levels(influence,caster->cur_loc,10) < 45)
 		spell = eSpell::SUMMON_MAJOR;
 	
 	l = caster->cur_loc;
@@ -3613,7 +3706,8 @@ bool monst_cast_mage(cCreature *caster,short targ) {
 						break;
 					j = get_ran(1,2,3);
 				}
-				sf::sleep(time_in_ticks(12)); // gives sound time to end
+				if(!headless)
+					sf::sleep(time_in_ticks(12)); // gives sound time to end
 				x = get_ran(4,1,4);
 				for(i = 0; i < j; i++){
 					play_sound(-61);
@@ -3685,7 +3779,8 @@ bool monst_cast_mage(cCreature *caster,short targ) {
 				x = get_ran(3,1,4);
 				play_sound(25);
 				play_sound(-61);
-				sf::sleep(time_in_ticks(12)); // gives sound time to end
+				if(!headless)
+					sf::sleep(time_in_ticks(12)); // gives sound time to end
 				summon_monster(85,caster->cur_loc,x,caster->attitude,caster->is_friendly());
 				break;
 			case eSpell::BLESS_MAJOR:
@@ -3783,8 +3878,12 @@ bool monst_cast_priest(cCreature *caster,short targ) {
 	
 	eSpell spell;
 	
-	target = find_fireball_loc(caster->cur_loc,1,caster->is_friendly(),&target_levels);
-	friend_levels_near = caster->is_friendly() ? count_levels(caster->cur_loc,3) : -1 * count_levels(caster->cur_loc,3);
+	influence_map_t influence;
+	build_influence_map(influence);
+	target = find_fireball_loc(influence,caster->cur_loc,1,caster->is_friendly(),&target_levels);
+	friend_levels_near = count_levels(influence,caster->cur_loc,3);
+	if(!caster->is_friendly())
+		friend_levels_near *= -1;
 	
 	if((caster->health * 4 < caster->m_health) && (get_ran(1,0,10) < 9))
 		spell = emer_spells[level][3];
@@ -4042,31 +4141,6 @@ void damage_target(short target,short dam,eDamageType type,short sound_type) {
 	else damage_monst(univ.town.monst[target - 100], 7, dam, type,sound_type);
 }
 
-
-//	target = find_fireball_loc(caster->m_loc,1,(caster->attitude == 1) ? 0 : 1,&target_levels);
-
-//short mode; // 0 - hostile casting  1 - friendly casting
-location find_fireball_loc(location where,short radius,short mode,short *m) {
-	location check_loc,cast_loc(120,0);
-	short cur_lev,level_max = 10;
-	
-	for(check_loc.x = 1; check_loc.x < univ.town->max_dim() - 1; check_loc.x ++)
-		for(check_loc.y = 1; check_loc.y < univ.town->max_dim() - 1; check_loc.y ++)
-			if(dist(where,check_loc) <= 8 && can_see(where,check_loc,sight_obscurity) < 5 && sight_obscurity(check_loc.x,check_loc.y) < 5) {
-				cur_lev = count_levels(check_loc,radius);
-				if(mode == 1)
-					cur_lev = cur_lev * -1;
-				if( ((cur_lev > level_max) || ((cur_lev == level_max) && (get_ran(1,0,1) == 0)))
-					&& (dist(where,check_loc) > radius)) {
-					level_max = cur_lev;
-					cast_loc = check_loc;
-				}
-			}
-	*m = level_max;
-	
-	return cast_loc;
-}
-
 location closest_pc_loc(location where) {
 	short i;
 	location pc_where(120,120);
@@ -4078,27 +4152,6 @@ location closest_pc_loc(location where) {
 	return pc_where;
 }
 
-short count_levels(location where,short radius) {
-	short i,store = 0;
-	
-	for(i = 0; i < univ.town.monst.size(); i++)
-		if(monst_near(i,where,radius,0)) {
-			if(!univ.town.monst[i].is_friendly())
-				store = store - univ.town.monst[i].level;
-			else store = store + univ.town.monst[i].level;
-		}
-	if(is_combat()) {
-		for(i = 0; i < 6; i++)
-			if(pc_near(i,where,radius))
-				store = store + 10;
-	}
-	if(is_town())
-		if(vdist(where,univ.town.p_loc) <= radius && can_see(where,univ.town.p_loc,sight_obscurity) < 5)
-			store += 20;
-	
-	return store;
-}
-
 bool pc_near(short pc_num,location where,short radius) {
 	// Assuming not looking
 	if(overall_mode >= MODE_COMBAT) {
@@ -4157,6 +4210,9 @@ static void place_spell_pattern(effect_pat_type pat,location center,unsigned sho
 	
 	
 	// First actually make barriers, then draw them, then inflict damaging effects.
+	// Plain fields are gathered into one area per type and then placed all at once.
+	cBitboard placing[SPECIAL_ROAD + 1], dispelling;
+	unsigned long placing_types = 0;
 	for(i = minmax(0,univ.town->max_dim() - 1,center.x - 4); i <= minmax(0,univ.town->max_dim() - 1,center.x + 4); i++)
 		for(j = minmax(0,univ.town->max_dim() - 1,center.y - 4); j <= minmax(0,univ.town->max_dim() - 1,center.y + 4); j++) {
 			effect = pat.pattern[i - center.x + 4][j - center.y + 4];
@@ -4165,81 +4221,36 @@ static void place_spell_pattern(effect_pat_type pat,location center,unsigned sho
 					case FIELD_WEB:
 						web_space(i,j);
 						break;
-					case BARRIER_FIRE:
-						univ.town.set_fire_barr(i,j,true);
-						break;
-					case BARRIER_FORCE:
-						univ.town.set_force_barr(i,j,true);
-						break;
-					case WALL_FORCE:
-						univ.town.set_force_wall(i, j, true);
-						break;
-					case WALL_FIRE:
-						univ.town.set_fire_wall(i,j,true);
-						break;
-					case FIELD_ANTIMAGIC:
-						univ.town.set_antimagic(i,j,true);
-						break;
 					case CLOUD_STINK:
 						scloud_space(i,j);
 						break;
-					case WALL_ICE:
-						univ.town.set_ice_wall(i,j,true);
-						break;
-					case WALL_BLADES:
-						univ.town.set_blade_wall(i,j,true);
-						break;
-					case FIELD_QUICKFIRE:
-						univ.town.set_quickfire(i,j,true);
-						break;
-					case FIELD_DISPEL:
-						dispel_fields(i,j,0);
-						break;
 					case CLOUD_SLEEP:
 						sleep_cloud_space(i,j);
 						break;
 					case FIELD_SMASH:
 						crumble_wall(loc(i,j));
 						break;
-					case OBJECT_CRATE:
-						univ.town.set_crate(i,j,true);
-						break;
-					case OBJECT_BARREL:
-						univ.town.set_barrel(i,j,true);
-						break;
-					case OBJECT_BLOCK:
-						univ.town.set_block(i,j,true);
-						break;
-					case BARRIER_CAGE:
-						univ.town.set_force_cage(i, j, true);
-						break;
-					case SFX_SMALL_BLOOD:
-						univ.town.set_sm_blood(i,j,true);
-						break;
-					case SFX_MEDIUM_BLOOD:
-						univ.town.set_med_blood(i,j,true);
-						break;
-					case SFX_LARGE_BLOOD:
-						univ.town.set_lg_blood(i,j,true);
-						break;
-					case SFX_SMALL_SLIME:
-						univ.town.set_sm_slime(i,j,true);
-						break;
-					case SFX_LARGE_SLIME:
-						univ.town.set_lg_slime(i,j,true);
-						break;
-					case SFX_ASH:
-						univ.town.set_ash(i,j,true);
-						break;
-					case SFX_BONES:
-						univ.town.set_bones(i,j,true);
+					case FIELD_DISPEL:
+						dispelling.set(i,j);
 						break;
-					case SFX_RUBBLE:
-						univ.town.set_rubble(i,j,true);
+					case BARRIER_FIRE: case BARRIER_FORCE: case BARRIER_CAGE:
+					case WALL_FORCE: case WALL_FIRE: case WALL_ICE: case WALL_BLADES:
+					case FIELD_ANTIMAGIC: case FIELD_QUICKFIRE:
+					case OBJECT_CRATE: case OBJECT_BARREL: case OBJECT_BLOCK:
+					case SFX_SMALL_BLOOD: case SFX_MEDIUM_BLOOD: case SFX_LARGE_BLOOD:
+					case SFX_SMALL_SLIME: case SFX_LARGE_SLIME:
+					case SFX_ASH: case SFX_BONES: case SFX_RUBBLE:
+						placing[effect].set(i,j);
+						placing_types |= eFieldType(effect);
 						break;
 				}
 			}
 		}
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		if(placing_types & eFieldType(f))
+			univ.town.place_fields(eFieldType(f), placing[f]);
+	if(dispelling.any())
+		dispel_fields(dispelling, 0);
 	draw_terrain(0);
 	if(is_town()) // now make things move faster if in town
 		fast_bang = 2;
@@ -5337,43 +5348,39 @@ void process_force_cage(location loc, short i, short adjust) {
 }
 
 void process_fields() {
+	cSubsystemTimer timer(eSubsystem::FIELDS);
 	short i,j,k,r1;
 	location loc;
-	short qf[64][64];
 	rectangle r;
 	
 	if(is_out())
 		return;
 	
+	eRandStream prev_stream = set_ran_stream(eRandStream::FIELDS);
+	cBitboard town_area = cBitboard::rect(0, 0, univ.town->max_dim() - 1, univ.town->max_dim() - 1);
 	if(univ.town.quickfire_present) {
 		r = univ.town->in_town_rect;
-		for(i = 0; i < univ.town->max_dim(); i++)
-			for(j = 0; j < univ.town->max_dim(); j++)
-				qf[i][j] = (univ.town.is_quickfire(i,j)) ? 2 : 0;
+		cBitboard interior = cBitboard::rect(r.left + 1, r.top + 1, r.right - 1, r.bottom - 1);
+		const cBitboard& quickfire = univ.town.fields[FIELD_QUICKFIRE];
+		cBitboard qf = quickfire & town_area;
+		ter_view_t town_ter = univ.town->terrain_view();
 		for(k = 0; k < ((is_combat()) ? 4 : 1); k++) {
-			for(i = r.left + 1; i < r.right ; i++)
-				for(j = r.top + 1; j < r.bottom ; j++)
-					if(univ.town.is_quickfire(i,j)) {
-						r1 = get_ran(1,1,8);
-						if(r1 != 1) {
-							qf[i - 1][j] = 1;
-							qf[i + 1][j] = 1;
-							qf[i][j + 1] = 1;
-							qf[i][j - 1] = 1;
-						}
-					}
-			for(i = r.left + 1; i < r.right ; i++)
-				for(j = r.top + 1; j < r.bottom ; j++)
-					if(qf[i][j] > 0) {
-						ter_num_t ter = univ.town->terrain(i,j);
-						if(univ.scenario.ter_types[ter].special == eTerSpec::CRUMBLING && univ.scenario.ter_types[ter].flag2 > 0) {
-							// TODO: This seems like the wrong sound
-							play_sound(60);
-							univ.town->terrain(i,j) = univ.scenario.ter_types[ter].flag1;
-							add_string_to_buf("  Quickfire burns through barrier.");
-						}
-						univ.town.set_quickfire(i,j,true);
-					}
+			// Each burning space has a 7 in 8 chance of spreading to its four neighbours.
+			cBitboard spreading = quickfire & interior;
+			for(i = 0; i < cBitboard::SIZE; i++)
+				spreading.col[i] = get_ran_bits(spreading.col[i], 7, 8, eRandStream::FIELDS);
+			qf |= spreading.grown();
+			(qf & interior).for_each([&town_ter](int i, int j) {
+				ter_num_t ter = town_ter(i,j);
+				if(univ.scenario.ter_types[ter].special == eTerSpec::CRUMBLING && univ.scenario.ter_types[ter].flag2 > 0) {
+					// TODO: This seems like the wrong sound
+					play_sound(60);
+					town_ter(i,j) = univ.scenario.ter_types[ter].flag1;
+					add_string_to_buf("  Quickfire burns through barrier.");
+				}
+				if(!univ.town.is_quickfire(i,j))
+					univ.town.set_quickfire(i,j,true);
+			});
 		}
 	}
 	
@@ -5385,8 +5392,15 @@ void process_fields() {
 	
 	// First fry PCs, then call to handle damage to monsters
 	processing_fields = true; // this, in hit_space, makes damage considered to come from whole party
-	for(i = 0; i < univ.town->max_dim(); i++)
-		for(j = 0; j < univ.town->max_dim(); j++) {
+	eFieldType decaying[] = {WALL_FORCE, WALL_FIRE, FIELD_ANTIMAGIC, CLOUD_STINK, CLOUD_SLEEP, WALL_ICE, WALL_BLADES, BARRIER_CAGE};
+	for(i = 0; i < univ.town->max_dim(); i++) {
+		// Only visit the spaces of this column that have something to process
+		uint64_t column = 0;
+		for(eFieldType type : decaying)
+			column |= univ.town.fields[type].col[i];
+		column &= town_area.col[i];
+		for(; column; column &= column - 1) {
+			j = cBitboard::lowest_bit(column);
 			if(univ.town.is_force_wall(i,j)) {
 				r1 = get_ran(3,1,6);
 				loc.x = i; loc.y = j;
@@ -5451,18 +5465,17 @@ void process_fields() {
 				}
 			}
 		}
+	}
 	
 	processing_fields = false;
+	set_ran_stream(prev_stream);
 	monsters_going = true; // this changes who the damage is considered to come from in hit_space
 	
 	if(univ.town.quickfire_present) {
-		for(i = 0; i < univ.town->max_dim(); i++)
-			for(j = 0; j < univ.town->max_dim(); j++)
-				if(univ.town.is_quickfire(i,j)) {
-					loc.x = i; loc.y = j;
-					r1 = get_ran(2,1,8);
-					hit_pcs_in_space(loc,r1,eDamageType::FIRE,1,1);
-				}
+		(univ.town.fields[FIELD_QUICKFIRE] & town_area).for_each([](int i, int j) {
+			short r1 = get_ran(2,1,8);
+			hit_pcs_in_space(location(i,j),r1,eDamageType::FIRE,1,1);
+		});
 	}
 	
 	monsters_going = false;
@@ -31,9 +31,7 @@ bool monst_breathe(cCreature *caster,location targ_space,uAbility dam_type);
 bool monst_cast_mage(cCreature *caster,short targ);
 bool monst_cast_priest(cCreature *caster,short targ);
 void damage_target(short target,short dam,eDamageType type,short sound_type = 0);
-location find_fireball_loc(location where,short radius,short mode,short *m);
 location closest_pc_loc(location where);
-short count_levels(location where,short radius);
 bool pc_near(short pc_num,location where,short radius);
 bool monst_near(short m_num,location where,short radius,short active);
 void fireball_space(location loc,short dam);
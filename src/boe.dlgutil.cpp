@@ -21,6 +21,7 @@
 #include <cstdio>
 #include "boe.newgraph.hpp"
 #include "boe.infodlg.hpp"
+#include "boe.timers.hpp"
 #include "graphtool.hpp"
 #include "mathutil.hpp"
 #include "strdlog.hpp"
@@ -575,6 +576,7 @@ void start_talk_mode(short m_num,short personality,mon_num_t monst_type,short st
 	
 	// Set the current town for talk strings
 	univ.town.prep_talk(personality / 10);
+	index_talk_nodes();
 	
 	// Dredge up critter's name
 	title_string = std::string(univ.town.cur_talk().people[personality % 10].title) + ":";
@@ -646,6 +648,7 @@ static void show_job_bank(int which_bank, std::string title) {
 		univ.party.quest_status[bank.jobs[which]] = eQuestStatus::STARTED;
 		univ.party.quest_source[bank.jobs[which]] = store_personality;
 		univ.party.quest_start[bank.jobs[which]] = univ.party.calc_day();
+		reload_timers(eTimerKind::QUEST);
 		// Now, if there are spare jobs available, fill in. Otherwise, clear space.
 		if(bank.jobs[4] >= 0)
 			std::swap(bank.jobs[which], bank.jobs[4]);
@@ -985,6 +988,7 @@ void handle_talk_event(location p) {
 					univ.party.quest_status[a] = eQuestStatus::STARTED;
 					univ.party.quest_source[a] = -1;
 					univ.party.quest_start[a] = univ.party.calc_day();
+					reload_timers(eTimerKind::QUEST);
 					break;
 				case eQuestStatus::STARTED:
 					break;
@@ -1127,6 +1131,7 @@ static bool prefs_event_filter (cDialog& me, std::string id, eKeyMod) {
 			set_pref("LessWanderingMonsters", dynamic_cast<cLed&>(me["lesswm"]).getState() != led_off);
 		} else {
 			univ.party.easy_mode = dynamic_cast<cLed&>(me["easier"]).getState() != led_off;
+			reload_timers(eTimerKind::QUEST); // Easy mode puts deadlines back
 			univ.party.less_wm = dynamic_cast<cLed&>(me["lesswm"]).getState() != led_off;
 		}
 		set_pref("DrawTerrainAnimation", dynamic_cast<cLed&>(me["noanim"]).getState() == led_off);
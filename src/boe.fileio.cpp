@@ -1,6 +1,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 #include "boe.global.hpp"
 #include "universe.hpp"
@@ -14,6 +15,8 @@
 #include "boe.dlgutil.hpp"
 #include "boe.infodlg.hpp"
 #include "boe.graphutil.hpp"
+#include "boe.replay.hpp"
+#include "boe.timers.hpp"
 #include "graphtool.hpp"
 #include "soundtool.hpp"
 #include "mathutil.hpp"
@@ -50,6 +53,9 @@ extern bool cur_scen_is_mac;
 void print_write_position ();
 void save_outdoor_maps();
 void add_outdoor_maps();
+static void load_out_quadrant(short i, short j);
+static void finish_build_outdoors();
+static void add_out_quadrant_map(short i, short j);
 
 short specials_res_id,data_dump_file_id;
 char start_name[256];
@@ -63,6 +69,7 @@ void finish_load_party(){
 	bool in_scen = univ.party.scen_name.length() > 0;
 	
 	party_in_memory = true;
+	reset_timers();
 	
 	// now if not in scen, this is it.
 	if(!in_scen) {
@@ -93,6 +100,7 @@ void finish_load_party(){
 	// if at this point, startup must be over, so make this call to make sure we're ready,
 	// graphics wise
 	end_startup();
+	preload_sounds();
 	
 	overall_mode = town_restore ? MODE_TOWN : MODE_OUTDOORS;
 	stat_screen_mode = MODE_INVEN;
@@ -127,120 +135,54 @@ void finish_load_party(){
 	store_file_reply = file_to_load;
 	
 	add_string_to_buf("Load: Game loaded.");
+	record_start_point();
 }
 
-void shift_universe_left() {
+// Moves the 2x2 window of loaded sectors one sector over. The sectors that stay
+// loaded are moved in place, so only the incoming ones are read from the scenario.
+static void shift_universe(short dx, short dy) {
 	short i,j;
 	
-	make_cursor_watch();
-	
 	save_outdoor_maps();
-	univ.party.outdoor_corner.x--;
-	univ.party.i_w_c.x++;
-	univ.party.p_loc.x += 48;
-	
-	for(i = 48; i < 96; i++)
-		for(j = 0; j < 96; j++)
-			univ.out.out_e[i][j] = univ.out.out_e[i - 48][j];
-	
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 96; j++)
-			univ.out.out_e[i][j] = 0;
+	univ.party.outdoor_corner.x += dx;
+	univ.party.outdoor_corner.y += dy;
+	univ.party.i_w_c.x -= dx;
+	univ.party.i_w_c.y -= dy;
+	univ.party.p_loc.x -= 48 * dx;
+	univ.party.p_loc.y -= 48 * dy;
+	univ.out.shift(dx, dy);
 	
 	for(i = 0; i < 10; i++) {
-		if(univ.party.out_c[i].m_loc.x > 48)
+		location& loc = univ.party.out_c[i].m_loc;
+		if((dx < 0 && loc.x > 48) || (dx > 0 && loc.x < 48) || (dy < 0 && loc.y > 48) || (dy > 0 && loc.y < 48))
 			univ.party.out_c[i].exists = false;
-		if(univ.party.out_c[i].exists)
-			univ.party.out_c[i].m_loc.x += 48;
+		if(univ.party.out_c[i].exists) {
+			loc.x -= 48 * dx;
+			loc.y -= 48 * dy;
+		}
 	}
 	
-	build_outdoors();
-	restore_cursor();
-	
+	for(i = 0; i < 2; i++)
+		for(j = 0; j < 2; j++)
+			if((dx != 0 && i == (dx > 0)) || (dy != 0 && j == (dy > 0)))
+				load_out_quadrant(i, j);
+	finish_build_outdoors();
+}
+
+void shift_universe_left() {
+	shift_universe(-1, 0);
 }
 
 void shift_universe_right() {
-	short i,j;
-	
-	make_cursor_watch();
-	save_outdoor_maps();
-	univ.party.outdoor_corner.x++;
-	univ.party.i_w_c.x--;
-	univ.party.p_loc.x -= 48;
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 96; j++)
-			univ.out.out_e[i][j] = univ.out.out_e[i + 48][j];
-	for(i = 48; i < 96; i++)
-		for(j = 0; j < 96; j++)
-			univ.out.out_e[i][j] = 0;
-	
-	
-	for(i = 0; i < 10; i++) {
-		if(univ.party.out_c[i].m_loc.x < 48)
-			univ.party.out_c[i].exists = false;
-		if(univ.party.out_c[i].exists)
-			univ.party.out_c[i].m_loc.x -= 48;
-	}
-	build_outdoors();
-	restore_cursor();
-	
+	shift_universe(1, 0);
 }
 
 void shift_universe_up() {
-	short i,j;
-	
-	make_cursor_watch();
-	save_outdoor_maps();
-	univ.party.outdoor_corner.y--;
-	univ.party.i_w_c.y++;
-	univ.party.p_loc.y += 48;
-	
-	for(i = 0; i < 96; i++)
-		for(j = 48; j < 96; j++)
-			univ.out.out_e[i][j] = univ.out.out_e[i][j - 48];
-	for(i = 0; i < 96; i++)
-		for(j = 0; j < 48; j++)
-			univ.out.out_e[i][j] = 0;
-	
-	for(i = 0; i < 10; i++) {
-		if(univ.party.out_c[i].m_loc.y > 48)
-			univ.party.out_c[i].exists = false;
-		if(univ.party.out_c[i].exists)
-			univ.party.out_c[i].m_loc.y += 48;
-	}
-	
-	build_outdoors();
-	restore_cursor();
-	
+	shift_universe(0, -1);
 }
 
 void shift_universe_down() {
-	short i,j;
-	
-	make_cursor_watch();
-	
-	save_outdoor_maps();
-	univ.party.outdoor_corner.y++;
-	univ.party.i_w_c.y--;
-	univ.party.p_loc.y = univ.party.p_loc.y - 48;
-	
-	for(i = 0; i < 96; i++)
-		for(j = 0; j < 48; j++)
-			univ.out.out_e[i][j] = univ.out.out_e[i][j + 48];
-	for(i = 0; i < 96; i++)
-		for(j = 48; j < 96; j++)
-			univ.out.out_e[i][j] = 0;
-	
-	for(i = 0; i < 10; i++) {
-		if(univ.party.out_c[i].m_loc.y < 48)
-			univ.party.out_c[i].exists = false;
-		if(univ.party.out_c[i].exists)
-			univ.party.out_c[i].m_loc.y = univ.party.out_c[i].m_loc.y - 48;
-	}
-	
-	build_outdoors();
-	restore_cursor();
-	
+	shift_universe(0, 1);
 }
 
 
@@ -274,27 +216,32 @@ void position_party(short out_x,short out_y,short pc_pos_x,short pc_pos_y) {
 
 
 void build_outdoors() {
-	short i,j;
-	size_t x = univ.party.outdoor_corner.x, y = univ.party.outdoor_corner.y;
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 48; j++) {
-			univ.out[i][j] = univ.scenario.outdoors[x][y]->terrain[i][j];
-			if(x + 1 < univ.scenario.outdoors.width())
-				univ.out[48 + i][j] = univ.scenario.outdoors[x+1][y]->terrain[i][j];
-			if(y + 1 < univ.scenario.outdoors.height())
-				univ.out[i][48 + j] = univ.scenario.outdoors[x][y+1]->terrain[i][j];
-			if(x + 1 < univ.scenario.outdoors.width() && y + 1 < univ.scenario.outdoors.height())
-				univ.out[48 + i][48 + j] = univ.scenario.outdoors[x+1][y+1]->terrain[i][j];
-		}
-	
+	for(short i = 0; i < 2; i++)
+		for(short j = 0; j < 2; j++)
+			load_out_quadrant(i, j);
+	finish_build_outdoors();
+}
+
+// Copies one of the four loaded sectors from the scenario into univ.out, and marks
+// what the party explored of it last time. Quadrants past the edge of the world are left alone.
+static void load_out_quadrant(short i, short j) {
+	size_t x = univ.party.outdoor_corner.x + i, y = univ.party.outdoor_corner.y + j;
+	if(x >= univ.scenario.outdoors.width() || y >= univ.scenario.outdoors.height())
+		return;
+	cOutdoors& sector = *univ.scenario.outdoors[x][y];
+	for(short k = 0; k < 48; k++)
+		std::copy(sector.terrain[k], sector.terrain[k] + 48, univ.out[48 * i + k] + 48 * j);
+	add_out_quadrant_map(i, j);
+}
+
+static void finish_build_outdoors() {
 	fix_boats();
-	add_outdoor_maps();
 //	make_out_trim();
 	// TODO: This might be another relic of the "demo" mode
 	if(overall_mode != MODE_STARTUP)
 		erase_out_specials();
 	
-	for(i = 0; i < 10; i++)
+	for(short i = 0; i < 10; i++)
 		if(univ.party.out_c[i].exists)
 			if((univ.party.out_c[i].m_loc.x < 0) || (univ.party.out_c[i].m_loc.y < 0) ||
 				(univ.party.out_c[i].m_loc.x > 95) || (univ.party.out_c[i].m_loc.y > 95))
@@ -313,65 +260,34 @@ short onm(char x_sector,char y_sector) {
 
 // This adds the current outdoor map info to the saved outdoor map info
 void save_outdoor_maps() {
-	short i,j;
-	
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 48; j++) {
-			if(univ.out.out_e[i][j] > 0)
-				univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y)][i / 8][j] =
-					univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y)][i / 8][j] |
-						(char) (1 << i % 8);
-			if(univ.party.outdoor_corner.x + 1 < univ.scenario.outdoors.width()) {
-				if(univ.out.out_e[i + 48][j] > 0)
-					univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y)][i / 8][j] =
-						univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y)][i / 8][j] |
-							(char) (1 << i % 8);
-			}
-			if(univ.party.outdoor_corner.y + 1 < univ.scenario.outdoors.height()) {
-				if(univ.out.out_e[i][j + 48] > 0)
-					univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y + 1)][i / 8][j] =
-						univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y + 1)][i / 8][j] |
-							(char) (1 << i % 8);
-			}
-			if((univ.party.outdoor_corner.y + 1 < univ.scenario.outdoors.height()) &&
-				(univ.party.outdoor_corner.x + 1 < univ.scenario.outdoors.width())) {
-				if(univ.out.out_e[i + 48][j + 48] > 0)
-					univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y + 1)][i / 8][j] =
-						univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y + 1)][i / 8][j] |
-							(char) (1 << i % 8);
-			}
+	size_t x = univ.party.outdoor_corner.x, y = univ.party.outdoor_corner.y;
+	for(short i = 0; i < 2; i++)
+		for(short j = 0; j < 2; j++) {
+			if(x + i >= univ.scenario.outdoors.width() || y + j >= univ.scenario.outdoors.height())
+				continue;
+			short n = onm(x + i,y + j);
+			for(short k = 0; k < 48; k++)
+				for(short l = 0; l < 48; l++)
+					if(univ.out.out_e[48 * i + k][48 * j + l] > 0)
+						univ.out_maps.explore(n,k,l);
 		}
 }
 
 void add_outdoor_maps() { // This takes the existing outdoor map info and supplements it with the saved map info
-	short i,j;
-	
-	for(i = 0; i < 48; i++)
-		for(j = 0; j < 48; j++) {
-			if((univ.out.out_e[i][j] == 0) &&
-				((univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y)][i / 8][j] &
-				  (char) (1 << i % 8)) != 0))
-			 	univ.out.out_e[i][j] = 1;
-			if(univ.party.outdoor_corner.x + 1 < univ.scenario.outdoors.width()) {
-				if((univ.out.out_e[i + 48][j] == 0) &&
-					((univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y)][i / 8][j] &
-					  (char) (1 << i % 8)) != 0))
-				 	univ.out.out_e[i + 48][j] = 1;
-			}
-			if(univ.party.outdoor_corner.y + 1 < univ.scenario.outdoors.height()) {
-				if((univ.out.out_e[i][j + 48] == 0) &&
-					((univ.out_maps[onm(univ.party.outdoor_corner.x,univ.party.outdoor_corner.y + 1)][i / 8][j] &
-					  (char) (1 << i % 8)) != 0))
-				 	univ.out.out_e[i][j + 48] = 1;
-			}
-			if((univ.party.outdoor_corner.y + 1 < univ.scenario.outdoors.height()) &&
-				(univ.party.outdoor_corner.x + 1 < univ.scenario.outdoors.width())) {
-				if((univ.out.out_e[i + 48][j + 48] == 0) &&
-					((univ.out_maps[onm(univ.party.outdoor_corner.x + 1,univ.party.outdoor_corner.y + 1)][i / 8][j] &
-					  (char) (1 << i % 8)) != 0))
-				 	univ.out.out_e[i + 48][j + 48] = 1;
-			}
-		}
+	for(short i = 0; i < 2; i++)
+		for(short j = 0; j < 2; j++)
+			add_out_quadrant_map(i, j);
+}
+
+static void add_out_quadrant_map(short i, short j) {
+	size_t x = univ.party.outdoor_corner.x + i, y = univ.party.outdoor_corner.y + j;
+	if(x >= univ.scenario.outdoors.width() || y >= univ.scenario.outdoors.height())
+		return;
+	short n = onm(x,y);
+	for(short k = 0; k < 48; k++)
+		for(short l = 0; l < 48; l++)
+			if((univ.out.out_e[48 * i + k][48 * j + l] == 0) && univ.out_maps.isExplored(n,k,l))
+				univ.out.out_e[48 * i + k][48 * j + l] = 1;
 }
 
 
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <cstdio>
 #include <list>
+#include <algorithm>
 
 #include "boe.global.hpp"
 
@@ -43,7 +44,7 @@ extern effect_pat_type current_pat;
 extern location ul;
 extern location center;
 extern short which_combat_type,current_pc;
-extern bool monsters_going,boom_anim_active;
+extern bool monsters_going,boom_anim_active,headless;
 extern sf::Image spell_pict;
 extern short current_ground;
 extern short num_targets_left;
@@ -62,6 +63,8 @@ extern cUniverse univ;
 extern cCustomGraphics spec_scen_g;
 extern sf::RenderWindow mini_map;
 bool map_visible = false;
+// Set when the window no longer shows the current state; cleared each time it is redrawn
+bool screen_damaged = true;
 extern std::string save_talk_str1, save_talk_str2;
 
 rectangle		menuBarRect;
@@ -92,6 +95,8 @@ sf::RenderTexture pc_stats_gworld;
 sf::RenderTexture item_stats_gworld;
 sf::RenderTexture text_area_gworld;
 sf::RenderTexture terrain_screen_gworld;
+// Collects the terrain view while draw_terrain builds it
+cSpriteBatch terrain_batch;
 sf::RenderTexture text_bar_gworld;
 sf::RenderTexture map_gworld;
 
@@ -386,7 +391,7 @@ void main_button_click(int which_button) {
 	
 	draw_buttons(which_button);
 	mainPtr.display();
-	play_sound(37, time_in_ticks(5));
+	play_sound(37);
 	draw_buttons(-1);
 	undo_clip(mainPtr);
 }
@@ -399,7 +404,7 @@ void arrow_button_click(rectangle button_rect) {
 	
 	refresh_stat_areas(1);
 	mainPtr.display();
-	play_sound(37, time_in_ticks(5));
+	play_sound(37);
 	undo_clip(mainPtr);
 	refresh_stat_areas(0);
 }
@@ -419,6 +424,7 @@ void reload_startup() {
 }
 
 void end_startup() {
+	if(headless) return;
 	load_main_screen();
 	
 	text_sbar->show();
@@ -466,6 +472,7 @@ void load_main_screen() {
 }
 
 void redraw_screen(int refresh) {
+	if(headless) return;
 	// We may need to update some of the offscreen textures
 	if(refresh & REFRESH_TERRAIN) draw_terrain(1);
 	if(refresh & REFRESH_STATS) put_pc_screen();
@@ -509,6 +516,7 @@ void redraw_screen(int refresh) {
 	done_btn->draw();
 	help_btn->draw();
 	mainPtr.display();
+	screen_damaged = false;
 }
 
 void put_background() {
@@ -546,6 +554,7 @@ void put_background() {
 
 // mode; -1 - all buttons, normal; otherwise draw this button pressed
 void draw_buttons(short mode) {
+	if(headless) return;
 	rectangle lg_rect = {0,0,38,38}, sm_rect[2] = {{0,38,19,76}, {19,38,38,76}}, dest_rec;
 	static const int MAX_TOOLBAR_BUTTONS = 14;
 	static const location null_loc(-1,-1);
@@ -625,6 +634,7 @@ void draw_text_bar() {
 	short i;
 	location loc;
 	
+	if(headless) return;
 	loc = (is_out()) ? global_to_local(univ.party.p_loc) : univ.town.p_loc;
 	
 	bool in_area = false;
@@ -720,6 +730,140 @@ bool is_nature(short x, short y, unsigned short ground_t) {
 std::vector<location> forcecage_locs;
 extern std::list<text_label_t> posted_labels;
 
+// What the last full pass drew in each cell of the view, so that the animated ones can be redrawn alone
+struct view_cell_t {
+	location where;
+	ter_num_t ter;
+	char can_draw;
+	bool frills;
+	short ground; // current_ground before the cell was drawn, which its trim may depend on
+	bool animated; // Its terrain or a field on it changes with anim_ticks
+	bool covered; // Something drawn after the cells (a monster, the party, a label, the unseen mask) overlaps it
+};
+static view_cell_t view_cells[9][9];
+static bool view_cells_valid = false;
+static unsigned long long view_cells_key;
+
+static void draw_view_cell(short q, short r) {
+	view_cell_t& cell = view_cells[q][r];
+	location where_draw = cell.where;
+	ter_num_t spec_terrain = cell.ter;
+	char can_draw = cell.can_draw;
+	
+	if((can_draw != 0) && (overall_mode != MODE_RESTING)) { // if can see, not a pit, and not resting
+		if(is_combat()) anim_ticks = 0;
+		
+		eTrimType trim = univ.scenario.ter_types[spec_terrain].trim_type;
+		
+		// Finally, draw this terrain spot
+		if(trim == eTrimType::WALKWAY){
+			int trim = -1;
+			unsigned short ground_t = univ.scenario.ter_types[spec_terrain].trim_ter;
+			ter_num_t ground_ter = univ.scenario.get_ter_from_ground(ground_t);
+			if(!loc_off_act_area(where_draw)) {
+				if(is_nature(where_draw.x - 1,where_draw.y,ground_t)){ // check left
+					if(is_nature(where_draw.x,where_draw.y - 1,ground_t)){ // check up
+						if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
+							if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
+								trim = 8;
+							else trim = 4;
+						}else if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
+							trim = 7;
+						else trim = 1;
+					}else if(is_nature(where_draw.x,where_draw.y + 1,ground_t)){ // check down
+						if(is_nature(where_draw.x + 1,where_draw.y,ground_t)) // check right
+							trim = 6;
+						else trim = 0;
+					}
+				}else if(is_nature(where_draw.x,where_draw.y - 1,ground_t)){ // check up
+					if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
+						if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
+							trim = 5;
+						else trim = 2;
+					}
+				}else if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
+					if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
+						trim = 3;
+				}
+			}
+			draw_one_terrain_spot(q,r,trim < 0 ? spec_terrain : ground_ter);
+			if(trim >= 0)
+				draw_trim(q,r,trim + 50,spec_terrain);
+		}else if(spec_terrain == 65535) {
+			draw_one_terrain_spot(q,r,-1);
+		}else{
+			current_ground = univ.scenario.get_ground_from_ter(spec_terrain);
+			draw_one_terrain_spot(q,r,spec_terrain);
+		}
+	}
+	else {  // Can't see. Place darkness.
+		draw_one_terrain_spot(q,r,-1);
+	}
+	
+	if((can_draw != 0) && (overall_mode != MODE_RESTING) && cell.frills)
+		place_trim((short) q,(short) r,where_draw,spec_terrain);
+//			if((is_town() && univ.town.is_spot(where_draw.x,where_draw.y)) ||
+//			   (is_out() && univ.out.outdoors[univ.party.i_w_c.x][univ.party.i_w_c.y].special_spot[where_draw.x][where_draw.y]))
+//				Draw_Some_Item(roads_gworld, calc_rect(6, 0), terrain_screen_gworld, loc(q,r), 1, 0);
+	// TODO: Move draw_sfx, draw_items, draw_fields, draw_spec_items, etc to here
+	
+	if(is_town() || is_combat())
+		draw_items(where_draw);
+	if(is_out() && univ.out.out_e[where_draw.x][where_draw.y] && univ.out.is_road(where_draw.x,where_draw.y))
+		place_road(q,r,where_draw,true);
+	else if(is_town() && univ.town.is_explored(where_draw.x,where_draw.y) && univ.town.is_road(where_draw.x, where_draw.y))
+		place_road(q,r,where_draw,true);
+	else place_road(q,r,where_draw,false);
+	draw_fields(where_draw);
+	//draw_monsters(where_draw);
+	//draw_vehicles(where_draw);
+	//if(is_combat) draw_pcs(where_draw); else draw_party(where_draw);
+}
+
+// Everything outside the view's cells that decides what is drawn in them; if this changes, they all need a full pass.
+static unsigned long long view_key() {
+	unsigned long long key = 14695981039346656037ull;
+	auto mix = [&key](long val) {
+		key ^= static_cast<unsigned long>(val);
+		key *= 1099511628211ull;
+	};
+	mix(overall_mode);
+	mix(center.x); mix(center.y);
+	mix(univ.party.p_loc.x); mix(univ.party.p_loc.y);
+	mix(univ.party.i_w_c.x); mix(univ.party.i_w_c.y);
+	mix(univ.party.outdoor_corner.x); mix(univ.party.outdoor_corner.y);
+	mix(univ.party.direction);
+	mix(univ.party.in_boat); mix(univ.party.in_horse);
+	mix(current_pc);
+	mix(fog_lifted);
+	if(!is_out()) {
+		mix(univ.town.num);
+		mix(univ.town.p_loc.x); mix(univ.town.p_loc.y);
+		for(short i = 0; i < univ.town.monst.size(); i++) {
+			mix(univ.town.monst[i].active);
+			mix(univ.town.monst[i].cur_loc.x); mix(univ.town.monst[i].cur_loc.y);
+			mix(univ.town.monst[i].direction);
+		}
+		mix(univ.town.items.size());
+	}
+	for(short i = 0; i < 6; i++) {
+		mix(int(univ.party[i].main_status));
+		mix(univ.party[i].combat_pos.x); mix(univ.party[i].combat_pos.y);
+		mix(univ.party[i].direction);
+	}
+	return key;
+}
+
+// Puts the finished terrain view on the window
+static void place_terrain_view() {
+	redraw_terrain();
+	draw_text_bar();
+	if((overall_mode >= MODE_COMBAT) && (overall_mode != MODE_LOOK_OUTDOORS) && (overall_mode != MODE_LOOK_TOWN) && (overall_mode != MODE_RESTING))
+		draw_pcs(center,1);
+	if(overall_mode == MODE_FANCY_TARGET)
+		draw_targets(center);
+}
+
 //mode ... if 1, don't place on screen after redoing
 // if 2, only redraw over active monst
 void draw_terrain(short	mode) {
@@ -727,12 +871,12 @@ void draw_terrain(short	mode) {
 	location where_draw;
 	location sector_p_in,view_loc;
 	char can_draw;
-	ter_num_t spec_terrain;
+	ter_num_t spec_terrain = 0;
 	bool off_terrain = false,draw_frills = true;
 	bool frills_on = get_bool_pref("DrawTerrainShoreFrills", true);
 	short i,j;
 	
-	if(overall_mode == MODE_TALKING || overall_mode == MODE_SHOPPING || overall_mode == MODE_STARTUP)
+	if(headless || overall_mode == MODE_TALKING || overall_mode == MODE_SHOPPING || overall_mode == MODE_STARTUP)
 		return;
 	
 	if(mode == 2) {
@@ -757,6 +901,7 @@ void draw_terrain(short	mode) {
 	}
 	
 	mainPtr.setActive();
+	terrain_batch.begin(terrain_screen_gworld);
 	
 	for(i = 0; i < 13; i++)
 		for(j = 0; j < 13; j++) {
@@ -790,6 +935,9 @@ void draw_terrain(short	mode) {
 		}
 	
 	forcecage_locs.clear();
+	ter_view_t town_ter = {};
+	if(!is_out())
+		town_ter = univ.town->terrain_view();
 	for(q = 0; q < 9; q++) {
 		for(r = 0; r < 9; r++) {
 			where_draw = (is_out()) ? univ.party.p_loc : center;
@@ -825,13 +973,13 @@ void draw_terrain(short	mode) {
 				}
 			}
 			else if(is_combat()) {
-				spec_terrain = univ.town->terrain(where_draw.x,where_draw.y);
+				spec_terrain = town_ter(where_draw.x,where_draw.y);
 				can_draw = (((is_explored(where_draw.x,where_draw.y)) ||
 							 (which_combat_type == 0) || (monsters_going) || (overall_mode != MODE_COMBAT))
 							&& (party_can_see(where_draw) < 6)) ? 1 : 0;
 			}
 			else {
-				spec_terrain = univ.town->terrain(where_draw.x,where_draw.y);
+				spec_terrain = town_ter(where_draw.x,where_draw.y);
 				can_draw = is_explored(where_draw.x,where_draw.y);
 				
 				if(can_draw > 0) {
@@ -845,74 +993,19 @@ void draw_terrain(short	mode) {
 			
 			if(fog_lifted) can_draw = true;
 			
-			if((can_draw != 0) && (overall_mode != MODE_RESTING)) { // if can see, not a pit, and not resting
-				if(is_combat()) anim_ticks = 0;
-				
-				eTrimType trim = univ.scenario.ter_types[spec_terrain].trim_type;
-				
-				// Finally, draw this terrain spot
-				if(trim == eTrimType::WALKWAY){
-					int trim = -1;
-					unsigned short ground_t = univ.scenario.ter_types[spec_terrain].trim_ter;
-					ter_num_t ground_ter = univ.scenario.get_ter_from_ground(ground_t);
-					if(!loc_off_act_area(where_draw)) {
-						if(is_nature(where_draw.x - 1,where_draw.y,ground_t)){ // check left
-							if(is_nature(where_draw.x,where_draw.y - 1,ground_t)){ // check up
-								if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
-									if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
-										trim = 8;
-									else trim = 4;
-								}else if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
-									trim = 7;
-								else trim = 1;
-							}else if(is_nature(where_draw.x,where_draw.y + 1,ground_t)){ // check down
-								if(is_nature(where_draw.x + 1,where_draw.y,ground_t)) // check right
-									trim = 6;
-								else trim = 0;
-							}
-						}else if(is_nature(where_draw.x,where_draw.y - 1,ground_t)){ // check up
-							if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
-								if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
-									trim = 5;
-								else trim = 2;
-							}
-						}else if(is_nature(where_draw.x + 1,where_draw.y,ground_t)){ // check right
-							if(is_nature(where_draw.x,where_draw.y + 1,ground_t)) // check down
-								trim = 3;
-						}
-					}
-					draw_one_terrain_spot(q,r,trim < 0 ? spec_terrain : ground_ter);
-					if(trim >= 0)
-						draw_trim(q,r,trim + 50,spec_terrain);
-				}else if(spec_terrain == 65535) {
-					draw_one_terrain_spot(q,r,-1);
-				}else{
-					current_ground = univ.scenario.get_ground_from_ter(spec_terrain);
-					draw_one_terrain_spot(q,r,spec_terrain);
-				}
-			}
-			else {  // Can't see. Place darkness.
-				draw_one_terrain_spot(q,r,-1);
-			}
-			
-			if((can_draw != 0) && (overall_mode != MODE_RESTING) && frills_on && draw_frills)
-				place_trim((short) q,(short) r,where_draw,spec_terrain);
-//			if((is_town() && univ.town.is_spot(where_draw.x,where_draw.y)) ||
-//			   (is_out() && univ.out.outdoors[univ.party.i_w_c.x][univ.party.i_w_c.y].special_spot[where_draw.x][where_draw.y]))
-//				Draw_Some_Item(roads_gworld, calc_rect(6, 0), terrain_screen_gworld, loc(q,r), 1, 0);
-			// TODO: Move draw_sfx, draw_items, draw_fields, draw_spec_items, etc to here
-			
-			if(is_town() || is_combat())
-				draw_items(where_draw);
-			if(is_out() && univ.out.out_e[where_draw.x][where_draw.y] && univ.out.is_road(where_draw.x,where_draw.y))
-				place_road(q,r,where_draw,true);
-			else if(is_town() && univ.town.is_explored(where_draw.x,where_draw.y) && univ.town.is_road(where_draw.x, where_draw.y))
-				place_road(q,r,where_draw,true);
-			else place_road(q,r,where_draw,false);
-			draw_fields(where_draw);
-			//draw_monsters(where_draw);
-			//draw_vehicles(where_draw);
-			//if(is_combat) draw_pcs(where_draw); else draw_party(where_draw);
+			view_cell_t& cell = view_cells[q][r];
+			cell.where = where_draw;
+			cell.ter = spec_terrain;
+			cell.can_draw = can_draw;
+			cell.frills = frills_on && draw_frills;
+			cell.covered = false;
+			cell.ground = current_ground;
+			// Note whether anything drawn in this cell changes with the animation
+			bool was_animating = anim_onscreen;
+			anim_onscreen = false;
+			draw_view_cell(q, r);
+			cell.animated = anim_onscreen;
+			anim_onscreen = anim_onscreen || was_animating;
 		}
 	}
 	
@@ -929,6 +1022,7 @@ void draw_terrain(short	mode) {
 //		draw_spec_items();
 //		}
 //
+	size_t first_overlay = terrain_batch.drawnRects().size();
 	// Not camping. Place misc. stuff
 	if(overall_mode != MODE_RESTING) {
 		if(is_out())
@@ -947,6 +1041,10 @@ void draw_terrain(short	mode) {
 	// TODO: Move into the above loop to eliminate global variable
 	for(location fc_loc : forcecage_locs)
 		Draw_Some_Item(*ResMgr::get<ImageRsrc>("fields"),calc_rect(2,0),terrain_screen_gworld,fc_loc,1,0);
+	terrain_batch.end();
+	std::vector<rectangle> overlays(terrain_batch.drawnRects().begin() + first_overlay, terrain_batch.drawnRects().end());
+	// Labels only last until the next full pass, so animating under them would leave them behind
+	bool had_labels = !posted_labels.empty();
 	// Draw any posted labels, then clear them out
 	clip_rect(terrain_screen_gworld, {13, 13, 337, 265});
 	for(text_label_t lbl : posted_labels)
@@ -956,21 +1054,57 @@ void draw_terrain(short	mode) {
 	
 	// Now do the light mask thing
 	apply_light_mask(false);
-	apply_unseen_mask();
+	apply_unseen_mask(&overlays);
 	
 	terrain_screen_gworld.display();
 	
-	if(mode == 0) {
-		redraw_terrain();
-		draw_text_bar();
-		if((overall_mode >= MODE_COMBAT) && (overall_mode != MODE_LOOK_OUTDOORS) && (overall_mode != MODE_LOOK_TOWN) && (overall_mode != MODE_RESTING))
-			draw_pcs(center,1);
-		if(overall_mode == MODE_FANCY_TARGET)
-			draw_targets(center);
-	}
+	// A pass that skipped some spaces didn't look at what's in them
+	view_cells_valid = !supressing_some_spaces && !had_labels;
+	view_cells_key = view_key();
+	for(q = 0; q < 9; q++)
+		for(r = 0; r < 9; r++) {
+			rectangle cell_rect = calc_rect(q,r);
+			cell_rect.offset(13,13);
+			view_cells[q][r].covered = std::any_of(overlays.begin(), overlays.end(), [&cell_rect](rectangle overlap) {
+				overlap &= cell_rect;
+				return overlap.width() > 0 && overlap.height() > 0;
+			});
+		}
+	
+	if(mode == 0)
+		place_terrain_view();
 	supressing_some_spaces = false;
 }
 
+void draw_animated_terrain() {
+	if(headless || overall_mode == MODE_TALKING || overall_mode == MODE_SHOPPING || overall_mode == MODE_STARTUP)
+		return;
+	// The cells can only be redrawn alone if nothing but the animation has changed since the last full pass,
+	// and nothing else is drawn over them.
+	bool can_redraw_cells = view_cells_valid && view_cells_key == view_key();
+	for(short q = 0; can_redraw_cells && q < 9; q++)
+		for(short r = 0; r < 9; r++)
+			if(view_cells[q][r].animated && view_cells[q][r].covered)
+				can_redraw_cells = false;
+	if(!can_redraw_cells) {
+		draw_terrain();
+		return;
+	}
+	
+	mainPtr.setActive();
+	anim_ticks++;
+	terrain_batch.begin(terrain_screen_gworld);
+	for(short q = 0; q < 9; q++)
+		for(short r = 0; r < 9; r++)
+			if(view_cells[q][r].animated) {
+				current_ground = view_cells[q][r].ground;
+				draw_view_cell(q, r);
+			}
+	terrain_batch.end();
+	terrain_screen_gworld.display();
+	place_terrain_view();
+}
+
 
 static ter_num_t get_ground_for_shore(ter_num_t ter){
 	if(univ.scenario.ter_types[ter].block_horse) return current_ground;
@@ -1198,7 +1332,7 @@ void draw_trim(short q,short r,short which_trim,ter_num_t ground_ter) {
 	}
 	to_rect = coord_to_rect(q,r);
 	
-	rect_draw_some_item(*from_gworld, from_rect, *mask, terrain_screen_gworld, to_rect);
+	terrain_batch.drawMasked(*from_gworld, from_rect, *mask, terrain_screen_gworld, to_rect);
 }
 
 
@@ -1266,32 +1400,32 @@ void place_road(short q,short r,location where,bool here) {
 	if(here){
 		to_rect = road_dest_rects[6];
 		to_rect.offset(13 + q * 28,13 + r * 36);
-		rect_draw_some_item(roads_gworld, road_rects[4], terrain_screen_gworld, to_rect);
+		terrain_batch.draw(roads_gworld, road_rects[4], terrain_screen_gworld, to_rect);
 		
 		if((where.y == 0) || extend_road_terrain(where.x, where.y - 1)) {
 			to_rect = road_dest_rects[0];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[1], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[1], terrain_screen_gworld, to_rect);
 		}
 		
 		if(((is_out()) && (where.x == 96)) || (!(is_out()) && (where.x == univ.town->max_dim() - 1))
 			|| extend_road_terrain(where.x + 1, where.y)) {
 			to_rect = road_dest_rects[1];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[0], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[0], terrain_screen_gworld, to_rect);
 		}
 		
 		if(((is_out()) && (where.y == 96)) || (!(is_out()) && (where.y == univ.town->max_dim() - 1))
 			|| extend_road_terrain(where.x, where.y + 1)) {
 			to_rect = road_dest_rects[2];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[1], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[1], terrain_screen_gworld, to_rect);
 		}
 		
 		if((where.x == 0) || extend_road_terrain(where.x - 1, where.y)) {
 			to_rect = road_dest_rects[3];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[0], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[0], terrain_screen_gworld, to_rect);
 		}
 	}else{
 		// TODO: I suspect this branch is now irrelevant.
@@ -1342,12 +1476,12 @@ void place_road(short q,short r,location where,bool here) {
 		if(horz){
 			to_rect = road_dest_rects[5];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[2], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[2], terrain_screen_gworld, to_rect);
 		}
 		if(vert){
 			to_rect = road_dest_rects[4];
 			to_rect.offset(13 + q * 28,13 + r * 36);
-			rect_draw_some_item (roads_gworld, road_rects[3], terrain_screen_gworld, to_rect);
+			terrain_batch.draw(roads_gworld, road_rects[3], terrain_screen_gworld, to_rect);
 		}
 	}
 }
@@ -1389,6 +1523,8 @@ void boom_space(location where,short mode,short type,short damage,short sound) {
 	
 //	if((cartoon_happening) && (anim_step < 140))
 //		return;
+	if(headless)
+		return;
 	if((mode != 100) && (party_can_see(where) == 6))
 		return;
 	if(type < 0 || type > 5)
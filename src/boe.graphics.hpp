@@ -37,6 +37,8 @@ void draw_text_bar();
 void refresh_text_bar();
 void put_text_bar(std::string str);
 void draw_terrain(short	mode = 0);
+// Redraws only the parts of the terrain view that animate, or all of it if that won't do
+void draw_animated_terrain();
 void place_trim(short q,short r,location where,ter_num_t ter_type);
 void draw_trim(short q,short r,short which_trim,short which_mode);
 void place_road(short q,short r,location where,bool here);
@@ -33,7 +33,7 @@ extern sf::RenderWindow mini_map;
 extern short combat_posing_monster , current_working_monster ; // 0-5 PC 100 + x - monster x
 
 extern sf::RenderTexture terrain_screen_gworld;
-extern std::queue<pending_special_type> special_queue;
+extern cSpriteBatch terrain_batch;
 
 extern location ul;
 extern location center;
@@ -73,7 +73,7 @@ void draw_one_terrain_spot (short i,short j,short terrain_to_draw) {
 	where_draw = calc_rect(i,j);
  	where_draw.offset(13,13);
  	if(terrain_to_draw == -1) {
-		fill_rect(terrain_screen_gworld, where_draw, sf::Color::Black);
+		terrain_batch.fill(terrain_screen_gworld, where_draw, sf::Color::Black);
 		return;
 	}
  	
@@ -112,7 +112,7 @@ void draw_one_terrain_spot (short i,short j,short terrain_to_draw) {
 			anim_onscreen = true;
 	}
 	
-	rect_draw_some_item(*source_gworld, source_rect, terrain_screen_gworld, where_draw);
+	terrain_batch.draw(*source_gworld, source_rect, terrain_screen_gworld, where_draw);
 }
 
 void draw_monsters() {
@@ -153,7 +153,7 @@ void draw_monsters() {
 																							 ((univ.party.out_c[i].direction < 4) ? 0 : (width * height)) + k);
 								to_rect = monst_rects[(width - 1) * 2 + height - 1][k];
 								to_rect.offset(13 + 28 * where_draw.x,13 + 36 * where_draw.y);
-								rect_draw_some_item(*src_gw, source_rect, terrain_screen_gworld,to_rect, sf::BlendAlpha);
+								terrain_batch.draw(*src_gw, source_rect, terrain_screen_gworld,to_rect, sf::BlendAlpha);
 							}
 						}
 						if(picture_wanted < 1000) {
@@ -163,7 +163,7 @@ void draw_monsters() {
 								to_rect.offset(13 + 28 * where_draw.x,13 + 36 * where_draw.y);
 								int which_sheet = m_pic_index[picture_wanted].i / 20;
 								sf::Texture& monst_gworld = *ResMgr::get<ImageRsrc>("monst" + std::to_string(1 + which_sheet));
-								rect_draw_some_item(monst_gworld, source_rect, terrain_screen_gworld,to_rect, sf::BlendAlpha);
+								terrain_batch.draw(monst_gworld, source_rect, terrain_screen_gworld,to_rect, sf::BlendAlpha);
 							}
 						}
 					}
@@ -312,7 +312,7 @@ void draw_items(location where){
 			}else{
 				graf_pos_ref(src_gw, from_rect) = calc_item_rect(univ.town.items[i].graphic_num, to_rect);
 			}
-			rect_draw_some_item(*src_gw, from_rect, terrain_screen_gworld, to_rect, sf::BlendAlpha);
+			terrain_batch.draw(*src_gw, from_rect, terrain_screen_gworld, to_rect, sf::BlendAlpha);
 		}
 	}
 }
@@ -403,8 +403,10 @@ void draw_fields(location where){
 		Draw_Some_Item(fields_gworld,calc_rect(6,0),terrain_screen_gworld,where_draw,1,0);
 	if(univ.town.is_barrel(where.x,where.y))
 		Draw_Some_Item(fields_gworld,calc_rect(7,0),terrain_screen_gworld,where_draw,1,0);
-	if(univ.town.is_fire_barr(where.x,where.y) || univ.town.is_force_barr(where.x,where.y))
+	if(univ.town.is_fire_barr(where.x,where.y) || univ.town.is_force_barr(where.x,where.y)) {
 		Draw_Some_Item(*ResMgr::get<ImageRsrc>("teranim"),calc_rect(8+(anim_ticks%4),4),terrain_screen_gworld,where_draw,1,0);
+		anim_onscreen = true;
+	}
 	if(univ.town.is_quickfire(where.x,where.y))
 		Draw_Some_Item(fields_gworld,calc_rect(7,1),terrain_screen_gworld,where_draw,1,0);
 	if(univ.town.is_sm_blood(where.x,where.y))
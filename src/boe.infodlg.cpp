@@ -34,6 +34,7 @@ extern std::map<eSkill,short> skill_max;
 extern std::map<eSkill,short> skill_g_cost;
 extern const char* skill_ids[19];
 extern short cur_town_talk_loaded;
+extern bool headless;
 extern sf::RenderWindow mainPtr;
 extern short on_monst_menu[256];
 
@@ -836,7 +837,7 @@ static void give_help(short help1,short help2,cDialog* parent) {
 		help_forced = true;
 		help1 -= 200;
 	}
-	if(!get_bool_pref("ShowInstantHelp", true) && !help_forced)
+	if(headless || (!get_bool_pref("ShowInstantHelp", true) && !help_forced))
 		return;
 	if(get_iarray_pref_contains("ReceivedHelp", help1))
 		return;
@@ -18,8 +18,10 @@
 #include "soundtool.hpp"
 #include "boe.monster.hpp"
 #include "boe.main.hpp"
+#include "boe.timers.hpp"
 #include "graphtool.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "strdlog.hpp"
 #include "3choice.hpp"
 #include "restypes.hpp"
@@ -256,8 +258,7 @@ short dist_from_party(location where) {
 void set_item_flag(cItem* item) {
 	if((item->is_special > 0) && (item->is_special < 65)) {
 		item->is_special--;
-		univ.party.item_taken[univ.town.num][item->is_special / 8] =
-			univ.party.item_taken[univ.town.num][item->is_special / 8] | (1 << item->is_special % 8);
+		univ.party.item_taken[univ.town.num].set(item->is_special);
 		item->is_special = 0;
 	}
 }
@@ -507,6 +508,7 @@ static bool display_item_event_filter(cDialog& me, std::string id, size_t& first
 			univ.party.quest_status[item.item_level] = eQuestStatus::STARTED;
 			univ.party.quest_start[item.item_level] = univ.party.calc_day();
 			univ.party.quest_source[item.item_level] = -1;
+			reload_timers(eTimerKind::QUEST);
 			set_item_flag(&item);
 		} else {
 			if(!allow_overload && item.item_weight() > univ.party[current_getting_pc].free_weight()) {
@@ -758,6 +760,7 @@ void place_treasure(location where,short level,short loot,short mode) {
 		{5,10,10,10,15,20,40,80,100,100},
 		{25,25,50,50,50,100,100,100,100,100}
 	};
+	eRandStream prev_stream = set_ran_stream(eRandStream::LOOT);
 	static const short min_chart[5][10] = {
 		{0,0,0,0,0,0,0,0,0,1},
 		{0,0,0,0,0,0,0,0,5,20},
@@ -842,6 +845,7 @@ void place_treasure(location where,short level,short loot,short mode) {
 			}
 		}
 	}
+	set_ran_stream(prev_stream);
 }
 
 cItem return_treasure(short loot) {
@@ -6,10 +6,12 @@
 #define BOOST_NO_CXX11_NUMERIC_LIMITS // Because my libc++ is old and not quite standard-compliant, which breaks Boost.Thread
 #include <boost/thread.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
 #include "boe.graphics.hpp"
 #include "boe.newgraph.hpp"
 #include "boe.fileio.hpp"
 #include "boe.actions.hpp"
+#include "boe.specials.hpp"
 #include "boe.text.hpp"
 #include "boe.party.hpp"
 #include "boe.items.hpp"
@@ -18,10 +20,14 @@
 #include "boe.dlgutil.hpp"
 #include "boe.infodlg.hpp"
 #include "boe.main.hpp"
+#include "boe.sim.hpp"
+#include "boe.replay.hpp"
+#include "boe.timers.hpp"
 #include "winutil.hpp"
 #include "soundtool.hpp"
 #include "graphtool.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "fileio.hpp"
 #include "strdlog.hpp"
 #include "choicedlog.hpp"
@@ -60,6 +66,7 @@ signed char dir_x_dif[9] = {0,1,1,1,0,-1,-1,-1,0};
 signed char dir_y_dif[9] = {-1,-1,0,1,1,1,0,-1,0};
 
 extern bool map_visible;
+extern bool screen_damaged;
 
 std::string scenario_temp_dir_name = "scenario";
 
@@ -73,6 +80,7 @@ bool anim_onscreen = false,changed_display_mode = false;
 short stat_window = 0;
 bool monsters_going = false,boom_anim_active = false;
 bool finished_init = false;
+bool headless = false; // Set by the combat simulator; nothing is drawn and nothing waits
 
 sf::RenderWindow mini_map;
 short which_item_page[6] = {0,0,0,0,0,0}; // Remembers which of the 2 item pages pc looked at
@@ -98,14 +106,34 @@ short missile_firer,current_monst_tactic;
 short store_current_pc = 0;
 
 sf::Clock animTimer;
+static sf::Clock frameTimer;
+// Even with nothing to do, look around this often, for the mini map's events and the like
+static const sf::Time max_idle_wait = sf::milliseconds(50);
 
 static void init_boe(int, char*[]);
+static void init_headless(const char* exec_path);
 
 int main(int argc, char* argv[]) {
 #if 0
 	void debug_oldstructs();
 	debug_oldstructs();
 #endif
+#ifdef BOE_SIMULATOR
+	// The standalone combat simulator; it never opens a window, so none of the rest applies
+	init_headless(argv[0]);
+	return run_combat_sim(argc, argv);
+#else
+	if(argc > 1 && argv[1] == std::string("--replay")) {
+		init_headless(argv[0]);
+		return run_replay(argc - 2, argv + 2);
+	}
+	if(argc > 2 && argv[1] == std::string("--record")) {
+		start_recording(argv[2]);
+		// Hide the option from the rest of startup, which takes argv[1] to be a game to load
+		argv[2] = argv[0];
+		argc -= 2;
+		argv += 2;
+	}
 	try{
 		init_boe(argc, argv);
 		
@@ -138,6 +166,7 @@ int main(int argc, char* argv[]) {
 		showFatalError("An unknown error occurred!");
 		throw;
 	}
+#endif
 }
 
 static void init_sbar(std::shared_ptr<cScrollbar>& sbar, rectangle rect, int max, int pgSz, int start = 0) {
@@ -179,6 +208,7 @@ void init_boe(int argc, char* argv[]) {
 		init_buf();
 		check_for_intel();
 		srand(time(nullptr));
+		seed_random(time(nullptr));
 		init_screen_locs();
 		Set_up_win();
 		init_startup();
@@ -191,6 +221,9 @@ void init_boe(int argc, char* argv[]) {
 	
 	cUniverse::print_result = iLiving::print_result = add_string_to_buf;
 	cPlayer::give_help = give_help;
+	cPlayer::quests_changed = []() {
+		reload_timers(eTimerKind::QUEST);
+	};
 	set_up_apple_events(argc, argv);
 	init_fileio();
 	init_spell_menus();
@@ -199,25 +232,79 @@ void init_boe(int argc, char* argv[]) {
 	showMenuBar();
 }
 
+// Just enough setup to run combat with no window; see boe.sim.cpp
+void init_headless(const char* exec_path) {
+	headless = true;
+	init_directories(exec_path);
+	mute_sounds(true);
+	// Replays still run dialogs, just without showing them
+	cDialog::init();
+	init_sbar(text_sbar, sbar_rect, 58, 11, 58);
+	init_sbar(item_sbar, item_sbar_rect, 16, 8);
+	init_sbar(shop_sbar, shop_sbar_rect, 16, 8);
+	init_buf();
+	cUniverse::print_result = iLiving::print_result = add_string_to_buf;
+	cPlayer::give_help = give_help;
+	cPlayer::quests_changed = []() {
+		reload_timers(eTimerKind::QUEST);
+	};
+	finished_init = true;
+}
+
+// The time between frames, or none if the frame rate isn't capped
+static sf::Time frame_interval() {
+	int fps = get_int_pref("MaxFrameRate", 60);
+	return fps > 0 ? sf::microseconds(1000000 / fps) : sf::Time::Zero;
+}
+
+static bool terrain_animating() {
+	return overall_mode != MODE_STARTUP && anim_onscreen && get_bool_pref("DrawTerrainAnimation", true) && !gInBackground;
+}
+
+// How long to wait for input before something else (an animation, a pending redraw) is due
+static sf::Time idle_wait() {
+	sf::Time wait = max_idle_wait;
+	if(overall_mode == MODE_STARTUP)
+		wait = std::min(wait, time_in_ticks(20) - animTimer.getElapsedTime());
+	else if(terrain_animating())
+		wait = std::min(wait, time_in_ticks(40) - animTimer.getElapsedTime());
+	if(screen_damaged)
+		wait = std::min(wait, frame_interval() - frameTimer.getElapsedTime());
+	return std::max(wait, sf::Time::Zero);
+}
+
 void Handle_One_Event() {
 	static const long twentyTicks = time_in_ticks(20).asMilliseconds();
 	static const long fortyTicks = time_in_ticks(40).asMilliseconds();
 	
 	through_sending();
-	Handle_Update();
+	if(special_chain_paused()) {
+		handle_paused_specials();
+		// The nodes it ran may well have changed what's on screen
+		screen_damaged = true;
+	}
 	
 	//(cur_time - last_anim_time > 42)
-	if((animTimer.getElapsedTime().asMilliseconds() >= fortyTicks) && (overall_mode != MODE_STARTUP) && (anim_onscreen) && get_bool_pref("DrawTerrainAnimation", true)
-	   && (!gInBackground)) {
+	if((animTimer.getElapsedTime().asMilliseconds() >= fortyTicks) && terrain_animating()) {
 		animTimer.restart();
-		draw_terrain();
+		draw_animated_terrain();
+		screen_damaged = true;
 	}
 	if((animTimer.getElapsedTime().asMilliseconds() > twentyTicks) && (overall_mode == MODE_STARTUP)) {
 		animTimer.restart();
 		draw_startup_anim(true);
+		screen_damaged = true;
+	}
+	// Only present a frame when something has changed, and no more often than the cap allows
+	if(screen_damaged && frameTimer.getElapsedTime() >= frame_interval()) {
+		frameTimer.restart();
+		Handle_Update();
 	}
 	
 	clear_sound_memory();
+	// Whatever waits on a sound also waits for a paused chain, as it does in a replay
+	if(!special_chain_paused())
+		update_sounds();
 	
 	if(map_visible && mini_map.pollEvent(event)){
 		if(event.type == sf::Event::Closed) {
@@ -225,21 +312,33 @@ void Handle_One_Event() {
 			map_visible = false;
 		} else if(event.type == sf::Event::GainedFocus)
 			makeFrontWindow(mainPtr);
+		screen_damaged = true;
 	}
+	// Leave the player's input waiting until a paused chain of specials is done with, so that
+	// it comes after the whole chain however many frames that takes, just as it does in a replay.
+	// The same goes for anything waiting on a sound to finish.
+	if(special_chain_paused() || sounds_pending())
+		return;
 	if(!mainPtr.pollEvent(event)) {
 		if(changed_display_mode) {
 			changed_display_mode = false;
 			adjust_window_mode();
+			screen_damaged = true;
 		}
 		flushingInput = false;
-		redraw_screen(REFRESH_NONE);
-		return;
+		if(!wait_for_event(mainPtr, event, idle_wait()))
+			return;
 	}
+	// The targeting line follows the mouse; otherwise moving it changes nothing on screen.
+	if(event.type != sf::Event::MouseMoved || !is_out())
+		screen_damaged = true;
 	switch(event.type) {
 		case sf::Event::KeyPressed:
 			if(flushingInput) return;
-			if(!(event.key.*systemKey))
+			if(!(event.key.*systemKey)) {
+				record_key(event);
 				handle_keystroke(event);
+			}
 			
 			break;
 			
@@ -349,7 +448,10 @@ void Mouse_Pressed() {
 			doneScrolling = true;
 			updater.join();
 			redraw_screen(REFRESH_DLOG);
-		} else All_Done = handle_action(event);
+		} else {
+			record_click(event);
+			All_Done = handle_action(event);
+		}
 	} else All_Done = handle_startup_press({event.mouseButton.x, event.mouseButton.y});
 	
 	menu_activate();
@@ -361,6 +463,7 @@ void close_program() {
 	// On the Mac, prefs are synced automatically. However, doing it manually won't hurt.
 	// On other platforms, we need to do it manually.
 	sync_prefs();
+	stop_recording();
 }
 
 extern fs::path progDir;
@@ -369,6 +472,9 @@ void handle_menu_choice(eMenu item_hit) {
 	sf::Event dummyEvent = {sf::Event::KeyPressed};
 	short i, choice;
 	
+	// Loading and saving would only get in the way of a replay.
+	if(item_hit > eMenu::FILE_SAVE_AS)
+		record_menu(item_hit);
 	switch(item_hit) {
 		case eMenu::NONE: break;
 		case eMenu::FILE_OPEN:
@@ -735,6 +841,8 @@ void pause(short length) {
 	
 	len = (long) length;
 	
+	if(headless) return;
+	
 	// Before pausing, make sure the screen is updated.
 	redraw_screen(REFRESH_NONE);
 	
@@ -0,0 +1,21 @@
+
+#include "boe.menus.hpp"
+
+// For builds with no display, such as the combat simulator; there's no menubar to keep up to date.
+
+void init_menubar() {}
+
+void adjust_monst_menu() {}
+
+void init_spell_menus() {}
+
+void adjust_spell_menus() {}
+
+void menu_activate() {}
+
+void hideMenuBar() {}
+
+void showMenuBar() {}
+
+// Nothing hands over files to open, either
+void set_up_apple_events(int, char*[]) {}
@@ -14,7 +14,9 @@
 #include "boe.graphics.hpp"
 #include "boe.newgraph.hpp"
 #include "boe.main.hpp"
+#include "boe.replay.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "graphtool.hpp"
 
 extern eGameMode overall_mode;
@@ -174,15 +176,41 @@ void set_up_monst(eAttitude mode,mon_num_t m_num) {
 	univ.town.monst[which].mobility = 1;
 }
 
+// Whether a monster that's about gets a turn.
+// A hostile monster that hasn't noticed the party doesn't move and has no target,
+// so until the party comes within waking range it has nothing to do.
+static bool takes_turn(cCreature& monst) {
+	if(monst.status[eStatus::ASLEEP] > 0 || monst.status[eStatus::PARALYZED] > 0)
+		return false;
+	if(monst.active == 1 && !monst.is_friendly()) {
+		monst.target = 6;
+		return dist(monst.cur_loc,univ.town.p_loc) <= 8;
+	}
+	return true;
+}
+
+static bool near_awake_monster(location where) {
+	for(size_t j : univ.town.monst.awake())
+		if(dist(where,univ.town.monst[j].cur_loc) <= 5)
+			return true;
+	return false;
+}
+
 void do_monsters() {
-	short i,j,r1,target;
+	cSubsystemTimer timer(eSubsystem::MONSTERS);
+	short r1,target;
 	location l1,l2;
 	bool acted_yet = false;
 	
-	if(overall_mode == MODE_TOWN)
-		for(i = 0; i < univ.town.monst.size(); i++)
-			if(univ.town.monst[i].active != 0 && univ.town.monst[i].status[eStatus::ASLEEP] <= 0
-			   && univ.town.monst[i].status[eStatus::PARALYZED] <= 0) {
+	eRandStream prev_stream = set_ran_stream(eRandStream::AI);
+	if(overall_mode == MODE_TOWN) {
+		// The town keeps track of which monsters are about, so the rest cost nothing.
+		// Looking up the next one each time means monsters that turn up partway through still get a turn.
+		const std::set<size_t>& present = univ.town.monst.present();
+		short i;
+		for(auto iter = present.begin(); iter != present.end(); iter = present.upper_bound(i)) {
+			i = *iter;
+			if(takes_turn(univ.town.monst[i])) {
 				// have to pick targets
 				if(univ.town.monst[i].active == 1)
 					target = 6;
@@ -249,15 +277,15 @@ void do_monsters() {
 							play_sound(18);
 						else play_sound(46);
 					}
-					for(j = 0; j < univ.town.monst.size(); j++)
-						if((univ.town.monst[j].active == 2)
-							&& ((dist(univ.town.monst[i].cur_loc,univ.town.monst[j].cur_loc) <= 5)))
-							univ.town.monst[i].active = 2;
+					if(univ.town.monst[i].active != 2 && near_awake_monster(univ.town.monst[i].cur_loc))
+						univ.town.monst[i].active = 2;
 				}
 				
 			}
+		}
+	}
 	if(overall_mode == MODE_OUTDOORS) {
-		for(i = 0; i < 10; i++)
+		for(short i = 0; i < 10; i++)
 			if(univ.party.out_c[i].exists) {
 				acted_yet = false;
 				l1 = univ.party.out_c[i].m_loc;
@@ -269,6 +297,7 @@ void do_monsters() {
 				else acted_yet = seek_party(i,l1,l2);
 			}
 	}
+	set_ran_stream(prev_stream);
 }
 
 bool monst_hate_spot(short which_m,location *good_loc) {
@@ -731,7 +760,7 @@ location find_clear_spot(location from_where,short mode) {
 			&& can_see_light(from_where,loc,combat_obscurity) == 0
 			&& (!is_combat() || univ.target_there(loc,TARG_PC) == nullptr)
 			&& (!(is_town()) || (loc != univ.town.p_loc))
-			&& (!(univ.town.fields[loc.x][loc.y] & blocking_fields))) {
+			&& (!(univ.town.get_fields(loc.x,loc.y) & blocking_fields))) {
 			if((mode == 0) || ((mode == 1) && (adjacent(from_where,loc))))
 				return loc;
 			else store_loc = loc;
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <cstdio>
 #include <vector>
+#include <unordered_map>
 
 #include "boe.global.hpp"
 
@@ -16,7 +17,9 @@
 #include "boe.text.hpp"
 #include "soundtool.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "graphtool.hpp"
+#include "lrucache.hpp"
 #include "scrollbar.hpp"
 #include <memory>
 #include "location.hpp"
@@ -53,7 +56,7 @@ extern tessel_ref_t bg[];
 extern sf::RenderWindow mainPtr;
 extern short which_combat_type;
 extern eGameMode overall_mode;
-extern bool boom_anim_active;
+extern bool boom_anim_active,headless;
 extern sf::RenderTexture terrain_screen_gworld;
 extern rectangle sbar_rect,item_sbar_rect,shop_sbar_rect;
 extern std::shared_ptr<cScrollbar> text_sbar,item_sbar,shop_sbar;
@@ -115,7 +118,7 @@ rectangle explode_place_rect[30];
 
 char last_light_mask[13][13];
 
-void apply_unseen_mask() {
+void apply_unseen_mask(std::vector<rectangle>* drawn) {
 	rectangle base_rect = {9,9,53,45},to_rect,big_to = {13,13,337,265};
 	short i,j;
 	bool need_bother = false;
@@ -143,12 +146,16 @@ void apply_unseen_mask() {
 				to_rect.offset(-28 + i * 28,-36 + 36 * j);
 				to_rect &= big_to;
 				tileImage(terrain_screen_gworld, to_rect, bw_pats[3], sf::BlendAlpha);
+				if(drawn) drawn->push_back(to_rect);
 			}
 }
 
+// Darkness masks for the light patterns seen most recently, since walking around a dark dungeon
+// tends to see the same ones again and again
+static cLruCache<std::string,std::shared_ptr<sf::Texture>> dark_masks(64);
+
 void apply_light_mask(bool onWindow) {
-	static Region dark_mask_region;
-	rectangle temp = {0,0,108,84},paint_rect,base_rect = {0,0,36,28};
+	static std::shared_ptr<sf::Texture> dark_mask;
 	rectangle big_to = {13,13,337,265};
 	short i,j;
 	bool same_mask = true;
@@ -160,8 +167,9 @@ void apply_light_mask(bool onWindow) {
 		return;
 	
 	if(onWindow) {
-		mainPtr.setActive();
-		fill_region(mainPtr, dark_mask_region, sf::Color::Black);
+		if(!dark_mask) return;
+		big_to.offset(5,5);
+		rect_draw_some_item(*dark_mask, rectangle(*dark_mask), big_to, ul, sf::BlendAlpha);
 		return;
 	}
 	
@@ -188,47 +196,32 @@ void apply_light_mask(bool onWindow) {
 			if(last_light_mask[i][j] != light_area[i][j])
 				same_mask = false;
 	
-	if(same_mask) {
+	if(same_mask && dark_mask) {
 		return;
 	}
 	
-	std::cout << "Current light mask:\n";
-	for(i = 0; i < 13; i++) {
-		for(j = 0; j < 13; j++)
-			std::cout << int(light_area[j][i]) << ' ';
-		std::cout << '\n';
+	if(get_bool_pref("TraceLightMask")) {
+		std::cout << "Current light mask:\n";
+		for(i = 0; i < 13; i++) {
+			for(j = 0; j < 13; j++)
+				std::cout << int(light_area[j][i]) << ' ';
+			std::cout << '\n';
+		}
 	}
 	
-	dark_mask_region.clear();
-	dark_mask_region.addRect(big_to);
 	for(i = 0; i < 13; i++)
 		for(j = 0; j < 13; j++)
 			last_light_mask[i][j] = light_area[i][j];
-	for(i = 1; i < 12; i++)
-		for(j = 1; j < 12; j++) {
-			if(light_area[i][j] == 2) {
-				int xOffset = 13 + 28 * (i - 3), yOffset = 13 + 36 * (j - 3);
-				Region oval_region;
-				oval_region.addEllipse(temp);
-				oval_region.offset(xOffset, yOffset);
-				dark_mask_region -= oval_region;
-			}
-			if(light_area[i][j] == 3) {
-				paint_rect = base_rect;
-				paint_rect.offset(13 + 28 * (i - 2),13 + 36 * (j - 2));
-				paint_rect.right += 28;
-				paint_rect.bottom += 36;
-				Region temp_rect_rgn;
-				temp_rect_rgn.addRect(paint_rect);
-				dark_mask_region -= temp_rect_rgn;
-				if(light_area[i + 1][j] == 3) light_area[i + 1][j] = 0;
-				if(light_area[i + 1][j + 1] == 3) light_area[i + 1][j + 1] = 0;
-				if(light_area[i][j + 1] == 3) light_area[i][j + 1] = 0;
-			}
-		}
-	
-	dark_mask_region.offset(5,5);
-	dark_mask_region.offset(ul);
+	std::string pattern(&light_area[0][0], &light_area[0][0] + 13 * 13);
+	if(std::shared_ptr<sf::Texture>* found = dark_masks.find(pattern)) {
+		dark_mask = *found;
+		return;
+	}
+	sf::Image mask;
+	make_dark_mask(light_area, mask);
+	dark_mask.reset(new sf::Texture);
+	dark_mask->loadFromImage(mask);
+	dark_masks.insert(pattern, dark_mask);
 }
 
 void start_missile_anim() {
@@ -258,7 +251,7 @@ void add_missile(location dest,miss_num_t missile_type,short path_type,short x_a
 	
 	if(!boom_anim_active)
 		return;
-	if(!get_bool_pref("DrawTerrainFrills", true))
+	if(headless || !get_bool_pref("DrawTerrainFrills", true))
 		return;
 	// lose redundant missiles
 	for(i = 0; i < 30; i++)
@@ -311,7 +304,7 @@ void mondo_boom(location l,short type,short snd) {
 void add_explosion(location dest,short val_to_place,short place_type,short boom_type,short x_adj,short y_adj) {
 	short i;
 	
-	if(!get_bool_pref("DrawTerrainFrills", true))
+	if(headless || !get_bool_pref("DrawTerrainFrills", true))
 		return;
 	if(!boom_anim_active)
 		return;
@@ -326,7 +319,7 @@ void add_explosion(location dest,short val_to_place,short place_type,short boom_
 	for(i = 0; i < 30; i++)
 		if(store_booms[i].boom_type < 0) {
 			have_boom = true;
-			store_booms[i].offset = (i == 0) ? 0 : -1 * get_ran(1,0,2);
+			store_booms[i].offset = (i == 0) ? 0 : -1 * ran_stream(eRandStream::ANIM).roll(1,0,2);
 			store_booms[i].dest = dest;
 			store_booms[i].val_to_place = val_to_place;
 			store_booms[i].place_type = place_type;
@@ -565,8 +558,8 @@ void do_explosion_anim(short /*sound_num*/,short special_draw, short snd) {
 			explode_place_rect[i].offset(current_terrain_ul);
 			
 			if((store_booms[i].place_type == 1) && (special_draw < 2)) {
-				temp_val = get_ran(1,0,50) - 25;
-				temp_val2 = get_ran(1,0,50) - 25;
+				temp_val = ran_stream(eRandStream::ANIM).roll(1,0,50) - 25;
+				temp_val2 = ran_stream(eRandStream::ANIM).roll(1,0,50) - 25;
 				explode_place_rect[i].offset(temp_val,temp_val2);
 			}
 		}
@@ -631,7 +624,7 @@ void click_shop_rect(rectangle area_rect) {
 	
 	draw_shop_graphics(1,area_rect);
 	mainPtr.display();
-	play_sound(37, time_in_ticks(5));
+	play_sound(37);
 	draw_shop_graphics(0,area_rect);
 	
 }
@@ -870,7 +863,7 @@ void click_talk_rect(word_rect_t word) {
 	win_draw_string(mainPtr, wordRect, word.word, eTextMode::LEFT_TOP, style);
 	place_talk_face();
 	mainPtr.display();
-	play_sound(37, time_in_ticks(5));
+	play_sound(37);
 	rect_draw_some_item(talk_gworld.getTexture(),talkRect,talk_area_rect,ul);
 	place_talk_face();
 }
@@ -1074,18 +1067,54 @@ void refresh_talking() {
 	place_talk_face();
 }
 
+// Talk nodes by personality and link, for the town currently being talked in;
+// each key maps to the first node with that link.
+static std::unordered_map<uint64_t, short> talk_index;
+static const cSpeech* talk_index_for = nullptr;
+
+// Equal for two strings exactly when strnicmp(a, b, 4) == 0
+static uint32_t fold_link(const char* link) {
+	uint32_t key = 0;
+	for(int i = 0; i < 4; i++) {
+		unsigned char c = tolower(static_cast<unsigned char>(link[i]));
+		key = key << 8 | c;
+		if(c == 0) {
+			key <<= 8 * (3 - i);
+			break;
+		}
+	}
+	return key;
+}
+
+static uint64_t talk_key(short personality, uint32_t link) {
+	return uint64_t(static_cast<unsigned short>(personality)) << 32 | link;
+}
+
+void index_talk_nodes() {
+	const cSpeech& talk = univ.town.cur_talk();
+	talk_index.clear();
+	for(short i = 0; i < talk.talk_nodes.size(); i++) {
+		const cSpeech::cNode& node = talk.talk_nodes[i];
+		if(node.personality == -1) continue;
+		// emplace keeps the earlier node if two share a link
+		talk_index.emplace(talk_key(node.personality, fold_link(node.link1)), i);
+		talk_index.emplace(talk_key(node.personality, fold_link(node.link2)), i);
+	}
+	talk_index_for = &talk;
+}
+
 short scan_for_response(const char *str) {
 	if(strnicmp(str, "    ", 4) == 1) return -1;
-	cSpeech talk = univ.town.cur_talk();
-	for(short i = 0; i < talk.talk_nodes.size(); i++) {
-		cSpeech::cNode node = talk.talk_nodes[i];
-		short personality = node.personality;
-		if(personality == -1) continue;
-		if(personality != store_personality && personality != -2)
-			continue;
-		if(strnicmp(str, node.link1, 4) == 0) return i;
-		if(strnicmp(str, node.link2, 4) == 0) return i;
+	if(talk_index_for != &univ.town.cur_talk())
+		index_talk_nodes();
+	uint32_t link = fold_link(str);
+	short found = -1;
+	// Nodes with personality -2 answer anyone
+	for(short personality : {store_personality, short(-2)}) {
+		auto iter = talk_index.find(talk_key(personality, link));
+		if(iter != talk_index.end() && (found < 0 || iter->second < found))
+			found = iter->second;
 	}
-	return -1;
+	return found;
 }
 
@@ -1,4 +1,5 @@
 
+#include <vector>
 #include <string>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include "location.hpp"
@@ -27,7 +28,8 @@ enum {
 	TALK_ASK = -16,
 };
 
-void apply_unseen_mask();
+// If given drawn, adds where it darkened the terrain view
+void apply_unseen_mask(std::vector<rectangle>* drawn = nullptr);
 void apply_light_mask(bool onWindow);
 void end_anim();
 void init_anim(short which_anim);
@@ -61,6 +63,8 @@ void refresh_shopping();
 std::string get_item_interesting_string(cItem item);
 void click_talk_rect(word_rect_t word);
 void place_talk_str(std::string str_to_place,std::string str_to_place2,short color,rectangle c_rect);
+// Call when a conversation starts, so the responses can be looked up by link
+void index_talk_nodes();
 short scan_for_response(const char *str);
 void refresh_talking();
 graf_pos calc_item_rect(int num,rectangle& to_rect);
@@ -29,12 +29,14 @@
 #include "boe.main.hpp"
 #include "graphtool.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "strdlog.hpp"
 #include "choicedlog.hpp"
 #include "pictchoice.hpp"
 #include "winutil.hpp"
 #include "fileio.hpp"
 #include "boe.menus.hpp"
+#include "boe.timers.hpp"
 #include "restypes.hpp"
 #include <boost/lexical_cast.hpp>
 #include "button.hpp"
@@ -77,7 +79,6 @@ extern short current_ground;
 extern location golem_m_locs[16];
 extern cUniverse univ;
 extern sf::Texture pc_gworld;
-extern std::queue<pending_special_type> special_queue;
 
 // First icon is displayed for positive values, second for negative, if -1 no negative icon.
 // This omits two special cases - major poison, and normal speed; they are hard-coded.
@@ -109,7 +110,7 @@ short store_pc_graphic;
 // Then, it inits the party properly for starting the scenario based
 // on the loaded scenario
 static void init_party_scen_data() {
-	short i,j,k,l;
+	short i,j;
 	bool stored_item = false;
 	
 	univ.party.age = 0;
@@ -167,6 +168,7 @@ static void init_party_scen_data() {
 	
 	univ.party.direction = DIR_N;
 	univ.party.at_which_save_slot = 0;
+	univ.party.can_find_town.clear();
 	for(i = 0; i < univ.scenario.towns.size(); i++)
 		univ.party.can_find_town[i] = !univ.scenario.towns[i]->is_hidden;
 	for(i = 0; i < 20; i++)
@@ -184,12 +186,8 @@ static void init_party_scen_data() {
 		}
 	}
 	
-	for(i = 0; i < 200; i++)
-		univ.party.m_killed[i] = 0;
-	
-	for(i = 0; i < 200; i++)
-		for(j = 0; j < 8; j++)
-			univ.party.item_taken[i][j] = 0;
+	univ.party.m_killed.clear();
+	univ.party.item_taken.clear();
 	
 	
 	refresh_store_items();
@@ -216,15 +214,8 @@ static void init_party_scen_data() {
 	for(i = 0; i < 3;i++)
 		univ.party.stored_items[i].clear();
 	
-	for(i = 0; i < 200; i++)
-		for(j = 0; j < 8; j++)
-			for(k = 0; k < 64; k++)
-				univ.town_maps[i][j][k] = 0;
-	
-	for(i = 0; i < 100; i++)
-		for(k = 0; k < 6; k++)
-			for(l = 0; l < 48; l++)
-				univ.out_maps[i][k][l] = 0;
+	univ.town_maps.clear();
+	univ.out_maps.clear();
 	
 }
 
@@ -276,8 +267,7 @@ void put_party_in_scen(std::string scen_name) {
 	if(item_took)
 		cChoiceDlog("removed-special-items").show();
 	univ.party.age = 0;
-	for(i = 0; i < 200; i++)
-		univ.party.m_killed[i] = 0;
+	univ.party.m_killed.clear();
 	univ.party.party_event_timers.clear();
 	
 	fs::path path = locate_scenario(scen_name);
@@ -291,6 +281,8 @@ void put_party_in_scen(std::string scen_name) {
 	
 	init_party_scen_data();
 	univ.party.scen_name = scen_name;
+	reset_timers();
+	preload_sounds();
 	
 	// if at this point, startup must be over, so make this call to make sure we're ready,
 	// graphics wise
@@ -303,8 +295,7 @@ void put_party_in_scen(std::string scen_name) {
 	current_pc = first_active_pc();
 	force_town_enter(univ.scenario.which_town_start,univ.scenario.where_start);
 	start_town_mode(univ.scenario.which_town_start,9);
-	while(!special_queue.empty())
-		special_queue.pop(); // Preserve legacy behaviour of not calling the "enter town" node at scenario start
+	clear_special_queue(); // Preserve legacy behaviour of not calling the "enter town" node at scenario start
 	center = univ.scenario.where_start;
 	update_explored(univ.scenario.where_start);
 	overall_mode = MODE_TOWN;
@@ -1610,6 +1601,45 @@ void dispel_fields(short i,short j,short mode) {
 		break_force_cage(loc(i,j));
 }
 
+// Same as above, but for a whole area at once; each field is removed from each space with the same odds.
+void dispel_fields(const cBitboard& area,short mode) {
+	cBitboard where = area & univ.town.town_area();
+	cBitboard* fields = univ.town.fields;
+	
+	if(mode == 2) {
+		fields[BARRIER_FIRE] -= where;
+		fields[BARRIER_FORCE] -= where;
+		fields[OBJECT_BARREL] -= where;
+		fields[OBJECT_CRATE] -= where;
+		fields[FIELD_WEB] -= where;
+	}
+	fields[WALL_FIRE] -= where;
+	fields[WALL_FORCE] -= where;
+	fields[CLOUD_STINK] -= where;
+	cBitboard cages = where & fields[BARRIER_CAGE];
+	if(mode >= 1) {
+		fields[FIELD_WEB] -= where;
+		fields[WALL_ICE] -= where;
+		fields[CLOUD_SLEEP] -= where;
+		fields[FIELD_QUICKFIRE] -= where;
+		fields[WALL_BLADES] -= where;
+	} else {
+		// Only spells dispel an area, so these draw from the combat stream like the rest of the spell.
+		for(int x = 0; x < cBitboard::SIZE; x++) {
+			if(!where.col[x]) continue;
+			fields[FIELD_WEB].col[x] &= ~get_ran_bits(where.col[x] & fields[FIELD_WEB].col[x], 1, 6, eRandStream::COMBAT);
+			fields[WALL_ICE].col[x] &= ~get_ran_bits(where.col[x] & fields[WALL_ICE].col[x], 5, 6, eRandStream::COMBAT);
+			fields[CLOUD_SLEEP].col[x] &= ~get_ran_bits(where.col[x] & fields[CLOUD_SLEEP].col[x], 4, 6, eRandStream::COMBAT);
+			fields[FIELD_QUICKFIRE].col[x] &= ~get_ran_bits(where.col[x] & fields[FIELD_QUICKFIRE].col[x], 1, 8, eRandStream::COMBAT);
+			fields[WALL_BLADES].col[x] &= ~get_ran_bits(where.col[x] & fields[WALL_BLADES].col[x], 4, 7, eRandStream::COMBAT);
+			cages.col[x] = get_ran_bits(cages.col[x], 2, 12, eRandStream::COMBAT);
+		}
+	}
+	cages.for_each([](int x, int y) {
+		break_force_cage(loc(x,y));
+	});
+}
+
 bool pc_can_cast_spell(short pc_num,eSkill type) {
 	if(type == eSkill::MAGE_SPELLS && pc_can_cast_spell(pc_num, eSpell::LIGHT))
 		return true;
@@ -1742,7 +1772,6 @@ static void draw_spell_info(cDialog& me, const eSkill store_situation, const sho
 
 static void put_target_status_graphics(cDialog& me, short for_pc) {
 	bool isAlive = univ.party[for_pc].main_status == eMainStatus::ALIVE;
-	univ.party[for_pc].status[eStatus::HASTE_SLOW]; // This just makes sure it exists in the map, without changing its value if it does
 	std::string id = "pc" + std::to_string(for_pc + 1);
 	int slot = 0;
 	for(auto next : univ.party[for_pc].status) {
@@ -5,6 +5,7 @@
 #include "spell.hpp"
 
 class cDialog;
+class cBitboard;
 void make_boats();
 bool create_pc(short spot,cDialog* parent_num);
 bool take_sp(short pc_num,short amt);
@@ -25,6 +26,7 @@ bool cast_spell_on_space(location where, eSpell spell);
 void crumble_wall(location where);
 void do_mindduel(short pc_num,cCreature *monst);
 void dispel_fields(short i,short j,short mode);
+void dispel_fields(const cBitboard& area,short mode);
 bool pc_can_cast_spell(short pc_num,eSpell spell_num);
 bool pc_can_cast_spell(short pc_num,eSkill spell_num);
 eSpell pick_spell(short pc_num,eSkill type);
@@ -0,0 +1,336 @@
+//
+//  boe.replay.cpp
+//  BoE
+//
+//  Records the player's input so a session can be replayed, as a benchmark and as a check
+//  that the game still does exactly the same thing.
+//
+
+#include "boe.global.hpp"
+#include "universe.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "boe.replay.hpp"
+#include "boe.actions.hpp"
+#include "boe.fileio.hpp"
+#include "boe.menus.hpp"
+#include "boe.specials.hpp"
+#include "fileio.hpp"
+#include "dialog.hpp"
+#include "prng.hpp"
+#include "soundtool.hpp"
+
+extern cUniverse univ;
+extern eGameMode overall_mode;
+extern bool All_Done;
+
+static const int NUM_SUBSYSTEMS = int(eSubsystem::SPECIALS) + 1;
+static const char* subsystem_names[NUM_SUBSYSTEMS] = {"Actions", "Monsters", "Fields", "Specials"};
+
+static bool timing = false;
+static sf::Clock timing_clock;
+static sf::Time subsystem_time[NUM_SUBSYSTEMS];
+static int subsystem_depth[NUM_SUBSYSTEMS];
+
+static fs::path record_file;
+static std::ofstream record;
+static bool record_started = false;
+static int num_start_points = 0;
+
+static std::ifstream playback;
+
+// Thrown when the replay stops doing what the recording did, and so can't go on
+struct xReplayDiverged {
+	std::string what;
+};
+
+cSubsystemTimer::cSubsystemTimer(eSubsystem which) : which(which) {
+	counting = timing && subsystem_depth[int(which)]++ == 0;
+	if(counting)
+		start = timing_clock.getElapsedTime();
+}
+
+cSubsystemTimer::~cSubsystemTimer() {
+	if(!timing) return;
+	subsystem_depth[int(which)]--;
+	if(counting)
+		subsystem_time[int(which)] += timing_clock.getElapsedTime() - start;
+}
+
+// FNV-1a
+static unsigned long long hash_string(const std::string& str) {
+	unsigned long long hash = 14695981039346656037ull;
+	for(unsigned char c : str) {
+		hash ^= c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+unsigned long long universe_hash() {
+	// The same things a saved game stores, less the maps
+	std::ostringstream state;
+	univ.party.writeTo(state);
+	for(int i = 0; i < 6; i++)
+		univ.party[i].writeTo(state);
+	if(!univ.party.scen_name.empty()) {
+		if(univ.town.num < 200)
+			univ.town.writeTo(state);
+		univ.out.writeTo(state);
+	}
+	// Not the animation stream, since a replay with nothing drawn never advances it
+	for(eRandStream which : {eRandStream::COMBAT, eRandStream::LOOT, eRandStream::AI, eRandStream::FIELDS}) {
+		ran_stream(which).writeTo(state);
+		state << '\n';
+	}
+	return hash_string(state.str());
+}
+
+// Only the events a dialog acts on; the rest would change nothing when replayed
+static void record_dialog_input(const sf::Event& event, eKeyMod mods) {
+	switch(event.type) {
+		case sf::Event::KeyPressed:
+			record << "DLOG KEY " << int(event.key.code) << ' ' << event.key.alt << ' ' << event.key.control;
+			record << ' ' << event.key.shift << ' ' << event.key.system << std::endl;
+			break;
+		case sf::Event::TextEntered:
+			record << "DLOG TEXT " << event.text.unicode << std::endl;
+			break;
+		case sf::Event::MouseButtonPressed:
+			record << "DLOG CLICK " << event.mouseButton.x << ' ' << event.mouseButton.y << ' ' << int(event.mouseButton.button);
+			record << ' ' << int(mods) << std::endl;
+			break;
+		case sf::Event::MouseButtonReleased:
+			record << "DLOG RELEASE " << event.mouseButton.x << ' ' << event.mouseButton.y << ' ' << int(event.mouseButton.button) << std::endl;
+			break;
+		case sf::Event::MouseMoved:
+			record << "DLOG MOVE " << event.mouseMove.x << ' ' << event.mouseMove.y << std::endl;
+			break;
+		default:
+			break;
+	}
+}
+
+void start_recording(fs::path file) {
+	record_file = file;
+	record.open(file.string().c_str());
+	if(!record) {
+		std::cerr << "Could not open " << file << " to record input." << std::endl;
+		return;
+	}
+	// Note where each dialog came up, then everything done in it, so the replay can answer it the same way.
+	cDialog::onRun = [](const std::string& name) {
+		if(!record_started) return;
+		record << "DIALOG " << name << std::endl;
+	};
+	cDialog::onInput = [](const sf::Event& event, eKeyMod mods) {
+		if(!record_started) return;
+		record_dialog_input(event, mods);
+	};
+}
+
+void stop_recording() {
+	if(!record.is_open()) return;
+	if(record_started)
+		record << "HASH " << universe_hash() << std::endl;
+	record.close();
+	cDialog::onRun = nullptr;
+	cDialog::onInput = nullptr;
+}
+
+void record_start_point() {
+	if(!record.is_open()) return;
+	// Save a copy, since the player may well save over the game they loaded.
+	fs::path start = record_file.string() + ".start" + std::to_string(++num_start_points) + ".exg";
+	if(!save_party(start, univ)) {
+		std::cerr << "Could not save the starting point for the recording." << std::endl;
+		return;
+	}
+	record << "PARTY " << start.string() << '\n';
+	write_random_state(record);
+	record.flush();
+	record_started = true;
+}
+
+void record_click(const sf::Event& event) {
+	if(!record_started) return;
+	record << "CLICK " << event.mouseButton.x << ' ' << event.mouseButton.y << ' ' << int(event.mouseButton.button) << std::endl;
+}
+
+void record_key(const sf::Event& event) {
+	if(!record_started) return;
+	record << "KEY " << int(event.key.code) << ' ' << event.key.alt << ' ' << event.key.control;
+	record << ' ' << event.key.shift << ' ' << event.key.system << std::endl;
+}
+
+void record_menu(eMenu item) {
+	if(!record_started) return;
+	record << "MENU " << int(item) << std::endl;
+}
+
+void record_spell_menu(eSpell spell) {
+	if(!record_started) return;
+	record << "SPELL " << int(spell) << std::endl;
+}
+
+// The next line of the recording, which has to be the given command for the replay to carry on
+static std::istringstream next_recorded(const std::string& want, const std::string& context) {
+	std::string cur, cmd;
+	if(!getline(playback, cur))
+		throw xReplayDiverged{"the recording ends inside the dialog " + context};
+	std::istringstream line(cur);
+	line >> cmd;
+	if(cmd != want)
+		throw xReplayDiverged{"the replay is in the dialog " + context + ", but the recording went on to " + cur};
+	return line;
+}
+
+static std::string cur_dialog;
+
+// Gives a dialog the same input it got when the recording was made
+static void replay_dialog_input(sf::Event& event, eKeyMod& mods) {
+	std::istringstream line = next_recorded("DLOG", cur_dialog);
+	std::string type;
+	line >> type;
+	int x, y, button, code;
+	if(type == "KEY") {
+		event.type = sf::Event::KeyPressed;
+		line >> code >> event.key.alt >> event.key.control >> event.key.shift >> event.key.system;
+		event.key.code = sf::Keyboard::Key(code);
+		mods = mod_none;
+	} else if(type == "TEXT") {
+		event.type = sf::Event::TextEntered;
+		line >> event.text.unicode;
+		mods = mod_none;
+	} else if(type == "CLICK" || type == "RELEASE") {
+		event.type = type == "CLICK" ? sf::Event::MouseButtonPressed : sf::Event::MouseButtonReleased;
+		line >> x >> y >> button;
+		event.mouseButton.x = x;
+		event.mouseButton.y = y;
+		event.mouseButton.button = sf::Mouse::Button(button);
+		int held = mod_none;
+		line >> held;
+		mods = eKeyMod(held);
+	} else if(type == "MOVE") {
+		event.type = sf::Event::MouseMoved;
+		line >> x >> y;
+		event.mouseMove.x = x;
+		event.mouseMove.y = y;
+		mods = mod_none;
+	} else throw xReplayDiverged{"the recording has input for the dialog " + cur_dialog + " that can't be read"};
+}
+
+static void replay_event(std::istringstream& line, const std::string& cmd) {
+	sf::Event event;
+	if(cmd == "CLICK") {
+		int x, y, button;
+		line >> x >> y >> button;
+		event.type = sf::Event::MouseButtonPressed;
+		event.mouseButton.x = x;
+		event.mouseButton.y = y;
+		event.mouseButton.button = sf::Mouse::Button(button);
+		All_Done = handle_action(event);
+	} else if(cmd == "KEY") {
+		int code;
+		event.type = sf::Event::KeyPressed;
+		line >> code >> event.key.alt >> event.key.control >> event.key.shift >> event.key.system;
+		event.key.code = sf::Keyboard::Key(code);
+		handle_keystroke(event);
+	} else if(cmd == "MENU") {
+		int item;
+		line >> item;
+		handle_menu_choice(eMenu(item));
+	} else if(cmd == "SPELL") {
+		int spell;
+		line >> spell;
+		handle_menu_spell(eSpell(spell));
+	}
+}
+
+int run_replay(int argc, char* argv[]) {
+	if(argc < 1) {
+		std::cerr << "Usage: --replay <recording>" << std::endl;
+		return 1;
+	}
+	playback.open(argv[0]);
+	if(!playback) {
+		std::cerr << "Could not open " << argv[0] << std::endl;
+		return 1;
+	}
+	// Dialogs are answered from the recording as they come up, in the order they came up when it was made
+	cDialog::onRun = [](const std::string& name) {
+		cur_dialog = name;
+		std::string which;
+		std::istringstream line = next_recorded("DIALOG", name);
+		getline(line >> std::ws, which);
+		if(which != name)
+			throw xReplayDiverged{"the replay opened the dialog " + name + " where the recording opened " + which};
+	};
+	cDialog::replayInput = replay_dialog_input;
+	timing = true;
+	bool have_hash = false;
+	unsigned long long expect_hash = 0;
+	int num_events = 0;
+	std::string cur;
+	sf::Time start = timing_clock.getElapsedTime();
+	try {
+		while(!All_Done && getline(playback, cur)) {
+			std::istringstream line(cur);
+			std::string cmd;
+			line >> cmd;
+			if(cmd == "PARTY") {
+				std::string file;
+				getline(line >> std::ws, file);
+				if(!load_party(file, univ)) {
+					std::cerr << "Could not load " << file << std::endl;
+					return 1;
+				}
+				finish_load_party();
+				post_load();
+			} else if(cmd == "SEED" || cmd == "STREAM") {
+				std::istringstream state(cur);
+				read_random_state(state);
+			} else if(cmd == "HASH") {
+				have_hash = bool(line >> expect_hash);
+			} else if(cmd == "DIALOG" || cmd == "DLOG") {
+				// The dialog would have read these itself if it had come up
+				throw xReplayDiverged{"the recording has a dialog here that the replay didn't open (" + cur + ")"};
+			} else {
+				replay_event(line, cmd);
+				num_events++;
+			}
+			// The game takes no input until a paused chain of specials is done, or until whatever
+			// waits on a sound has run, so neither does the replay. Sounds are muted, so that's at once.
+			while(special_chain_paused() || sounds_pending()) {
+				while(special_chain_paused())
+					handle_paused_specials();
+				update_sounds();
+			}
+		}
+	} catch(xReplayDiverged& err) {
+		std::cerr << "The replay can't go past event " << num_events + 1 << ": " << err.what << std::endl;
+		return 1;
+	}
+	sf::Time total = timing_clock.getElapsedTime() - start;
+	timing = false;
+
+	std::cout << "Replayed " << num_events << " events in " << total.asSeconds() << "s\n";
+	for(int i = 0; i < NUM_SUBSYSTEMS; i++)
+		std::cout << "  " << subsystem_names[i] << ": " << subsystem_time[i].asSeconds() << "s\n";
+	const special_stats_t& spec = special_stats();
+	std::cout << "  Special nodes: " << spec.nodes << " in " << spec.ticks << " ticks, at most " << spec.peak_tick << " in one\n";
+	unsigned long long hash = universe_hash();
+	std::cout << "State hash: " << hash;
+	if(!have_hash) {
+		std::cout << " (the recording has none to compare)" << std::endl;
+		return 0;
+	} else if(hash != expect_hash) {
+		std::cout << " DIFFERS from the recording (" << expect_hash << ")" << std::endl;
+		return 1;
+	}
+	std::cout << " (matches the recording)" << std::endl;
+	return 0;
+}
@@ -0,0 +1,54 @@
+//
+//  boe.replay.hpp
+//  BoE
+//
+//  Records the player's input so a session can be replayed, as a benchmark and as a check
+//  that the game still does exactly the same thing.
+//
+
+#ifndef BOE_GAME_REPLAY_H
+#define BOE_GAME_REPLAY_H
+
+#include <string>
+#include <boost/filesystem/path.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/System.hpp>
+
+namespace fs = boost::filesystem; // TODO: Centralize this alias!
+
+enum class eMenu;
+enum class eSpell;
+
+// Parts of the game timed separately in a replay. The times are inclusive;
+// for example, specials run by a monster's turn count towards both.
+enum class eSubsystem {ACTIONS, MONSTERS, FIELDS, SPECIALS};
+
+// Adds the time until it goes out of scope to the subsystem's total, when timing is on.
+// Only the outermost timer counts if a subsystem calls back into itself.
+class cSubsystemTimer {
+	eSubsystem which;
+	bool counting;
+	sf::Time start;
+public:
+	explicit cSubsystemTimer(eSubsystem which);
+	~cSubsystemTimer();
+};
+
+void start_recording(fs::path file);
+void stop_recording();
+// Called once a game has been loaded; the replay starts from a copy of it.
+void record_start_point();
+void record_click(const sf::Event& event);
+void record_key(const sf::Event& event);
+void record_menu(eMenu item);
+void record_spell_menu(eSpell spell);
+
+// A hash of the saved state of the party and the current town or outdoors
+unsigned long long universe_hash();
+
+// Arguments (after --replay): the recording.
+// Dialogs get the same input they got in the recording, without opening, so they come out the same way.
+// If the replay opens a different dialog from the recording, or none, it stops there with an error.
+int run_replay(int argc, char* argv[]);
+
+#endif
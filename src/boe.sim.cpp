@@ -0,0 +1,261 @@
+//
+//  boe.sim.cpp
+//  BoE
+//
+//  Runs town combats with no window, for balance testing.
+//
+
+#include "boe.global.hpp"
+#include "universe.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <boost/filesystem/operations.hpp>
+#include <boost/thread.hpp>
+
+#include "boe.sim.hpp"
+#include "boe.actions.hpp"
+#include "boe.combat.hpp"
+#include "boe.fileio.hpp"
+#include "boe.locutils.hpp"
+#include "boe.party.hpp"
+#include "boe.specials.hpp"
+#include "boe.town.hpp"
+#include "fileio.hpp"
+#include "mathutil.hpp"
+#include "prng.hpp"
+
+extern cUniverse univ;
+extern eGameMode overall_mode;
+extern short current_pc;
+
+// A fight that hasn't ended after this many PC actions is called a draw.
+static const size_t MAX_ACTIONS = 2000;
+static const eSpell attack_spells[] = {eSpell::FLAME, eSpell::SPARK, eSpell::WOUND};
+
+struct sim_result {
+	bool won = false, timed_out = false;
+	// How long each PC action took, including any monster turns it set off, in microseconds
+	std::vector<long> action_time;
+};
+
+static cCreature* nearest_enemy(location from) {
+	cCreature* best = nullptr;
+	short best_dist = 0;
+	for(short i = 0; i < univ.town.monst.size(); i++) {
+		cCreature& monst = univ.town.monst[i];
+		if(monst.active == 0 || monst.is_friendly())
+			continue;
+		short d = dist(from, monst.cur_loc);
+		if(best == nullptr || d < best_dist) {
+			best = &monst;
+			best_dist = d;
+		}
+	}
+	return best;
+}
+
+// Stands in for the player: casts an attack spell at the nearest enemy if it can,
+// otherwise walks towards it and attacks once adjacent.
+static void sim_pc_act() {
+	cPlayer& pc = univ.party[current_pc];
+	short ap = pc.ap;
+	location from = pc.combat_pos;
+	cCreature* target = nearest_enemy(from);
+	if(target == nullptr) {
+		char_stand_ready();
+		return;
+	}
+	location to = target->cur_loc;
+	if(!adjacent(from, to)) {
+		for(eSpell spell : attack_spells) {
+			if(pc_can_cast_spell(current_pc, spell) && dist(from, to) <= (*spell).range) {
+				start_spell_targeting(spell);
+				do_combat_cast(to);
+				overall_mode = MODE_COMBAT;
+				break;
+			}
+		}
+		if(pc.ap < ap)
+			return;
+	}
+	short dx = minmax(-1, 1, to.x - from.x), dy = minmax(-1, 1, to.y - from.y);
+	location steps[3] = {{from.x + dx, from.y + dy}, {from.x + dx, from.y}, {from.x, from.y + dy}};
+	for(location step : steps) {
+		if(step == from)
+			continue;
+		pc_combat_move(step);
+		if(pc.ap < ap || !pc.is_alive())
+			return;
+	}
+	// Boxed in; don't let the fight stall on this PC.
+	char_stand_ready();
+}
+
+static bool enemies_left() {
+	for(short i = 0; i < univ.town.monst.size(); i++)
+		if(univ.town.monst[i].active > 0 && !univ.town.monst[i].is_friendly())
+			return true;
+	return false;
+}
+
+static bool run_encounter(fs::path file, uint64_t seed, sim_result& result) {
+	if(!load_party(file, univ))
+		return false;
+	finish_load_party();
+	if(overall_mode != MODE_TOWN)
+		return false;
+	// After loading, since the save carries its own random state
+	seed_random(seed);
+	start_town_combat(univ.party.direction);
+	sf::Clock timer;
+	while(univ.party.is_alive() && enemies_left()) {
+		if(result.action_time.size() >= MAX_ACTIONS) {
+			result.timed_out = true;
+			return true;
+		}
+		timer.restart();
+		sim_pc_act();
+		combat_next_step();
+		// The player couldn't act again until any paused chain of specials was done
+		while(special_chain_paused())
+			handle_paused_specials();
+		result.action_time.push_back(timer.getElapsedTime().asMicroseconds());
+	}
+	result.won = univ.party.is_alive();
+	return true;
+}
+
+static void write_result(std::ostream& out, const sim_result& result) {
+	out << result.won << ' ' << result.timed_out << ' ' << result.action_time.size();
+	for(long t : result.action_time)
+		out << ' ' << t;
+	out << std::endl;
+}
+
+static bool read_result(std::istream& in, sim_result& result) {
+	size_t n;
+	if(!(in >> result.won >> result.timed_out >> n))
+		return false;
+	result.action_time.resize(n);
+	for(long& t : result.action_time)
+		if(!(in >> t))
+			return false;
+	return true;
+}
+
+// Runs encounters first, first + stride, ... below count; encounter n uses seed + n,
+// so the results don't depend on how the encounters were split between workers.
+// Each result is written out as soon as it's known, so a worker that fails partway still leaves what it finished.
+static bool run_worker(fs::path file, uint64_t seed, int first, int count, int stride, std::ostream& out) {
+	for(int n = first; n < count; n += stride) {
+		sim_result result;
+		if(!run_encounter(file, seed + n, result)) {
+			std::cerr << "Could not start a fight from " << file << "; it must be a game saved in town." << std::endl;
+			return false;
+		}
+		write_result(out, result);
+	}
+	return true;
+}
+
+static std::string quoted(std::string arg) {
+	return '"' + arg + '"';
+}
+
+// The game keeps its state in globals, so each worker is the simulator run again as a separate process,
+// with a universe of its own. Each one writes its results to a file of its own, which is read back once it exits.
+// Returns how many of the workers failed; the results of the rest, and whatever the failed ones finished, are kept.
+static int run_workers(std::string exec_path, fs::path file, uint64_t seed, int count, int workers, std::vector<sim_result>& results) {
+	std::vector<fs::path> outputs;
+	std::vector<int> status(workers);
+	boost::thread_group waiting;
+	for(int w = 0; w < workers; w++) {
+		fs::path output = fs::temp_directory_path()/fs::unique_path("boesim-%%%%-%%%%-%%%%.txt");
+		std::ostringstream command;
+		command << quoted(exec_path) << " --worker " << w << ' ' << workers << ' ' << quoted(file.string());
+		command << ' ' << count << ' ' << seed << ' ' << quoted(output.string());
+		std::string cmd = command.str();
+#ifdef _WIN32
+		// The Windows shell strips the outermost quotes off the command, so give it a spare pair
+		cmd = quoted(cmd);
+#endif
+		int& worker_status = status[w];
+		waiting.create_thread([cmd, &worker_status]() {
+			worker_status = system(cmd.c_str());
+		});
+		outputs.push_back(output);
+	}
+	waiting.join_all();
+	int failed = 0;
+	for(int w = 0; w < workers; w++) {
+		if(status[w] != 0)
+			failed++;
+		std::ifstream in(outputs[w].string().c_str());
+		sim_result result;
+		while(read_result(in, result))
+			results.push_back(result);
+		in.close();
+		boost::system::error_code err;
+		fs::remove(outputs[w], err);
+	}
+	return failed;
+}
+
+static long percentile(const std::vector<long>& sorted, double p) {
+	if(sorted.empty()) return 0;
+	return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+static void report(const std::vector<sim_result>& results, uint64_t seed, int workers, sf::Time elapsed) {
+	int won = 0, timed_out = 0;
+	std::vector<long> times;
+	for(const sim_result& result : results) {
+		if(result.won) won++;
+		if(result.timed_out) timed_out++;
+		times.insert(times.end(), result.action_time.begin(), result.action_time.end());
+	}
+	int lost = results.size() - won - timed_out;
+	double total = std::max<size_t>(results.size(), 1);
+	std::sort(times.begin(), times.end());
+	std::cout << results.size() << " fights (seed " << seed << ", " << workers << " workers) in " << elapsed.asSeconds() << "s\n";
+	std::cout << "  Won:       " << won << " (" << 100 * won / total << "%)\n";
+	std::cout << "  Lost:      " << lost << " (" << 100 * lost / total << "%)\n";
+	std::cout << "  Timed out: " << timed_out << " (" << 100 * timed_out / total << "%)\n";
+	std::cout << "  Actions per fight: " << times.size() / total << '\n';
+	std::cout << "  Turn time (us): 50% " << percentile(times, 0.5) << ", 90% " << percentile(times, 0.9);
+	std::cout << ", 99% " << percentile(times, 0.99) << ", max " << percentile(times, 1) << std::endl;
+}
+
+int run_combat_sim(int argc, char* argv[]) {
+	if(argc > 7 && argv[1] == std::string("--worker")) {
+		std::ofstream out(argv[7]);
+		bool ok = run_worker(argv[4], strtoull(argv[6], nullptr, 10), atoi(argv[2]), atoi(argv[5]), atoi(argv[3]), out);
+		out.close();
+		return ok && out ? 0 : 1;
+	}
+	if(argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <saved game> [fights=1000] [seed=1] [workers]" << std::endl;
+		return 1;
+	}
+	fs::path file = argv[1];
+	int count = argc > 2 ? atoi(argv[2]) : 1000;
+	uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+	int workers = argc > 4 ? atoi(argv[4]) : boost::thread::hardware_concurrency();
+	workers = std::max(1, std::min(workers, count));
+
+	std::vector<sim_result> results;
+	sf::Clock timer;
+	int failed = run_workers(argv[0], file, seed, count, workers, results);
+	report(results, seed, workers, timer.getElapsedTime());
+	if(failed > 0) {
+		std::cerr << failed << " of " << workers << " workers failed, so only " << results.size() << " of the ";
+		std::cerr << count << " fights are counted above." << std::endl;
+		return 1;
+	}
+	return 0;
+}
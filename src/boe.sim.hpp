@@ -0,0 +1,17 @@
+//
+//  boe.sim.hpp
+//  BoE
+//
+//  Runs town combats with no window, for balance testing.
+//
+
+#ifndef BOE_GAME_SIM_H
+#define BOE_GAME_SIM_H
+
+// The main function of the standalone simulator, which has no window and builds on Linux as well.
+// Arguments: saved game, then optionally number of encounters, seed, and workers.
+// The game must be saved in the town where the fight is to take place.
+// Each worker is the simulator run again in a process of its own, with --worker and where to write its results.
+int run_combat_sim(int argc, char* argv[]);
+
+#endif
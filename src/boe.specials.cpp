@@ -32,6 +32,8 @@
 #include <array>
 #include "spell.hpp"
 #include "boe.menus.hpp"
+#include "boe.replay.hpp"
+#include "boe.timers.hpp"
 
 extern sf::RenderWindow mainPtr;
 extern eGameMode overall_mode;
@@ -47,7 +49,6 @@ extern sf::RenderWindow mini_map;
 extern short fast_bang;
 extern bool end_scenario;
 extern cUniverse univ;
-extern std::queue<pending_special_type> special_queue;
 extern short combat_posing_monster;
 
 bool can_draw_pcs = true;
@@ -1795,14 +1796,39 @@ void push_things() {
 	}
 }
 
+// The deadline for a started quest has passed.
+static void fail_quest(int which) {
+	if(univ.party.quest_status[which] != eQuestStatus::STARTED)
+		return;
+	cQuest& quest = univ.scenario.quests[which];
+	univ.party.quest_status[which] = eQuestStatus::FAILED;
+	if(univ.party.quest_source[which] >= 0) {
+		int bank = univ.party.quest_source[which];
+		// Safety valve in case it was given by a special node
+		if(bank >= univ.party.job_banks.size())
+			univ.party.job_banks.resize(bank + 1);
+		int add_anger = 1;
+		if(quest.flags % 10 == 1) {
+			if(quest.deadline < 20)
+				add_anger++;
+			if(quest.deadline < 10)
+				add_anger++;
+			if(quest.deadline < 5)
+				add_anger++;
+		} else if(quest.deadline - univ.party.quest_start[which] > 20)
+			add_anger++;
+		univ.party.job_banks[bank].anger += add_anger;
+	}
+}
+
 void special_increase_age(long length, bool queue) {
-	size_t i;
-	short s1,s2,s3;
+	short s1,s2,s3 = 0;
 	bool redraw = false,stat_area = false;
 	location trigger_loc;
 	unsigned long age_before = univ.party.age - length;
 	unsigned long current_age = univ.party.age;
 	bool failed_job = false;
+	timer_event_t timer;
 	
 	if(is_combat()) {
 		extern short combat_active_pc;
@@ -1813,36 +1839,45 @@ void special_increase_age(long length, bool queue) {
 		trigger_loc = univ.party.p_loc;
 	}
 	
-	for(auto& p : univ.party.quest_status) {
-		if(p.second != eQuestStatus::STARTED)
-			continue;
-		cQuest& quest = univ.scenario.quests[p.first];
-		if(quest.deadline <= 0)
-			continue;
-		bool is_relative = quest.flags % 10;
-		int deadline = quest.deadline + is_relative * univ.party.quest_start[p.first];
-		if(day_reached(deadline + 1, quest.event)) {
-			p.second = eQuestStatus::FAILED;
-			if(univ.party.quest_source[p.first] >= 0) {
-				int bank = univ.party.quest_source[p.first];
-				// Safety valve in case it was given by a special node
-				if(bank >= univ.party.job_banks.size())
-					univ.party.job_banks.resize(bank + 1);
-				int add_anger = 1;
-				if(quest.flags % 10 == 1) {
-					if(quest.deadline < 20)
-						add_anger++;
-					if(quest.deadline < 10)
-						add_anger++;
-					if(quest.deadline < 5)
-						add_anger++;
-				} else if(quest.deadline - univ.party.quest_start[p.first] > 20)
-					add_anger++;
-				univ.party.job_banks[bank].anger += add_anger;
-			}
-			failed_job = true;
+	bool town_timers = is_town() || (is_combat() && which_combat_type == 1);
+	prepare_timers(age_before, town_timers ? univ.town.num : -1);
+	// Only the timers that go off are looked at, in the order they go off
+	while(next_timer(age_before, current_age, timer)) {
+		switch(timer.kind) {
+			case eTimerKind::QUEST:
+				fail_quest(timer.which);
+				failed_job = true;
+				continue;
+			case eTimerKind::TOWN:
+				if(queue) {
+					univ.party.age = timer.when;
+					queue_special(eSpecCtx::TOWN_TIMER, 2, univ.town->timers[timer.which].node, trigger_loc);
+				} else run_special(eSpecCtx::TOWN_TIMER,2,univ.town->timers[timer.which].node,trigger_loc,&s1,&s2,&s3);
+				break;
+			case eTimerKind::SCENARIO:
+				if(queue) {
+					univ.party.age = timer.when;
+					queue_special(eSpecCtx::SCEN_TIMER, 0, univ.scenario.scenario_timers[timer.which].node, trigger_loc);
+				} else run_special(eSpecCtx::SCEN_TIMER,0,univ.scenario.scenario_timers[timer.which].node,trigger_loc,&s1,&s2,&s3);
+				break;
+			case eTimerKind::PARTY: {
+				// Done with before it runs, in case the special starts another timer
+				cTimer& party_timer = univ.party.party_event_timers[timer.which];
+				short which_type = party_timer.node_type, node = party_timer.node;
+				party_timer.node = -1;
+				univ.party.age = timer.when;
+				if(queue)
+					queue_special(eSpecCtx::PARTY_TIMER, which_type, node, trigger_loc);
+				else run_special(eSpecCtx::PARTY_TIMER, which_type, node, trigger_loc, &s1, &s2, &s3);
+				break;
+			}
 		}
+		univ.party.age = current_age;
+		stat_area = true;
+		if(s3 > 0)
+			redraw = true;
 	}
+	univ.party.age = current_age;
 	if(failed_job) {
 		add_string_to_buf("The deadline for one of your quests has passed.",2);
 		print_buf();
@@ -1852,57 +1887,9 @@ void special_increase_age(long length, bool queue) {
 	
 	// Angered job boards slowly forgive you
 	if(univ.party.age % 30 == 0)
-		for(i = 0; i < univ.party.job_banks.size(); i++)
+		for(size_t i = 0; i < univ.party.job_banks.size(); i++)
 			move_to_zero(univ.party.job_banks[i].anger);
 	
-	if(is_town() || (is_combat() && which_combat_type == 1)) {
-		for(i = 0; i < univ.town->timers.size(); i++)
-			if(univ.town->timers[i].time > 0) {
-				short time = univ.town->timers[i].time;
-				for(unsigned long j = age_before + (time == 1); j <= current_age; j++)
-					if(j % time == 0) {
-						if(queue) {
-							univ.party.age = j;
-							queue_special(eSpecCtx::TOWN_TIMER, 2, univ.town->timers[i].node, trigger_loc);
-						} else run_special(eSpecCtx::TOWN_TIMER,2,univ.town->timers[i].node,trigger_loc,&s1,&s2,&s3);
-					}
-				stat_area = true;
-				if(s3 > 0)
-					redraw = true;
-			}
-	}
-	univ.party.age = current_age;
-	for(i = 0; i < univ.scenario.scenario_timers.size(); i++)
-		if(univ.scenario.scenario_timers[i].time > 0) {
-			short time = univ.scenario.scenario_timers[i].time;
-			for(unsigned long j = age_before + (time == 1); j <= current_age; j++)
-				if(j % time == 0) {
-					if(queue) {
-						univ.party.age = j;
-						queue_special(eSpecCtx::SCEN_TIMER, 0, univ.scenario.scenario_timers[i].node, trigger_loc);
-					} else run_special(eSpecCtx::SCEN_TIMER,0,univ.scenario.scenario_timers[i].node,trigger_loc,&s1,&s2,&s3);
-				}
-			stat_area = true;
-			if(s3 > 0)
-				redraw = true;
-		}
-	univ.party.age = current_age;
-	auto party_timers = univ.party.party_event_timers;
-	for(i = 0; i < party_timers.size(); i++) {
-		if(party_timers[i].time <= length) {
-			univ.party.age = age_before + party_timers[i].time;
-			short which_type = party_timers[i].node_type;
-			if(queue)
-				queue_special(eSpecCtx::PARTY_TIMER, which_type, party_timers[i].node, trigger_loc);
-			else run_special(eSpecCtx::PARTY_TIMER, which_type, party_timers[i].node, trigger_loc, &s1, &s2, &s3);
-			univ.party.party_event_timers[i].time = 0;
-			univ.party.party_event_timers[i].node = -1;
-			stat_area = true;
-			if(s3 > 0)
-				redraw = true;
-		} else univ.party.party_event_timers[i].time -= length;
-	}
-	univ.party.age = current_age;
 	if(stat_area) {
 		put_pc_screen();
 		put_item_screen(stat_window);
@@ -1911,24 +1898,96 @@ void special_increase_age(long length, bool queue) {
 		draw_terrain(0);
 }
 
+// Specials set off while another is running, or by something that can't run one itself,
+// wait here. The most urgent run first, and otherwise in the order they were set off.
+static const size_t MAX_QUEUED_SPECIALS = 256;
+// A queued chain that runs past this many nodes in one tick carries on next frame.
+static const int NODES_PER_TICK = 1000;
+
+struct queued_special_t {
+	pending_special_type spec;
+	int priority;
+	unsigned long order;
+	// Who the chain had picked, as for get_target, if it was paused partway through;
+	// otherwise -1, to choose from the context as usual.
+	size_t picked = -1;
+	// std::priority_queue takes the greatest first
+	bool operator<(const queued_special_t& other) const {
+		if(priority != other.priority)
+			return priority > other.priority;
+		return order > other.order;
+	}
+};
+
+static std::priority_queue<queued_special_t> special_queue;
+static unsigned long num_queued = 0;
+static queued_special_t paused_chain;
+static bool chain_paused = false;
+static int nodes_this_tick = 0;
+static special_stats_t spec_stats;
+
+// Lower runs first: the direct result of what the player did, then moving between areas,
+// then whatever was set off in combat, and timers last.
+static int special_priority(eSpecCtx mode) {
+	switch(mode) {
+		case eSpecCtx::OUT_MOVE: case eSpecCtx::TOWN_MOVE: case eSpecCtx::COMBAT_MOVE:
+		case eSpecCtx::OUT_LOOK: case eSpecCtx::TOWN_LOOK: case eSpecCtx::TALK: case eSpecCtx::HAIL:
+		case eSpecCtx::USE_SPEC_ITEM: case eSpecCtx::USE_SPACE: case eSpecCtx::TARGET:
+		case eSpecCtx::SHOPPING: case eSpecCtx::DROP_ITEM:
+			return 0;
+		case eSpecCtx::LEAVE_TOWN: case eSpecCtx::ENTER_TOWN: case eSpecCtx::TOWN_HOSTILE: case eSpecCtx::STARTUP:
+		case eSpecCtx::OUTDOOR_ENC: case eSpecCtx::FLEE_ENCOUNTER: case eSpecCtx::WIN_ENCOUNTER:
+			return 1;
+		case eSpecCtx::KILL_MONST: case eSpecCtx::SEE_MONST: case eSpecCtx::MONST_SPEC_ABIL:
+		case eSpecCtx::ATTACKING_MELEE: case eSpecCtx::ATTACKING_RANGE:
+		case eSpecCtx::ATTACKED_MELEE: case eSpecCtx::ATTACKED_RANGE:
+			return 2;
+		case eSpecCtx::TOWN_TIMER: case eSpecCtx::SCEN_TIMER: case eSpecCtx::PARTY_TIMER:
+			break;
+	}
+	return 3;
+}
+
 void queue_special(eSpecCtx mode, unsigned short which_type, short spec, location spec_loc) {
 	if(spec < 0) return;
-	pending_special_type queued_special;
-	queued_special.spec = spec;
-	queued_special.where = spec_loc;
-	queued_special.type = which_type;
-	queued_special.mode = mode;
-	queued_special.trigger_time = univ.party.age;
-	special_queue.push(queued_special);
+	if(special_queue.size() >= MAX_QUEUED_SPECIALS) {
+		// Most likely a special that keeps setting itself off
+		spec_stats.dropped++;
+		if(univ.debug_mode)
+			add_string_to_buf("Warning: Too many specials queued up; one was dropped.", 4);
+		return;
+	}
+	queued_special_t queued;
+	queued.spec.spec = spec;
+	queued.spec.where = spec_loc;
+	queued.spec.type = which_type;
+	queued.spec.mode = mode;
+	queued.spec.trigger_time = univ.party.age;
+	queued.priority = special_priority(mode);
+	queued.order = num_queued++;
+	special_queue.push(queued);
 }
 
-void run_special(pending_special_type spec, short* a, short* b, short* redraw) {
-	unsigned long store_time = univ.party.age;
-	univ.party.age = spec.trigger_time;
-	run_special(spec.mode, spec.type, spec.spec, spec.where, a, b, redraw);
-	univ.party.age = std::max(univ.party.age, store_time);
+void clear_special_queue() {
+	while(!special_queue.empty())
+		special_queue.pop();
+	chain_paused = false;
+}
+
+bool special_chain_paused() {
+	return chain_paused;
 }
 
+const special_stats_t& special_stats() {
+	return spec_stats;
+}
+
+typedef void (*spec_handler_t)(eSpecCtx,const cSpecial&,short,short*,short*,short*,short*,short*);
+// Indexed by eSpecCat
+static const spec_handler_t spec_handlers[] = {
+	general_spec, oneshot_spec, affect_spec, ifthen_spec, townmode_spec, rect_spec, outdoor_spec,
+};
+
 // This is the big painful one, the main special engine
 // which_mode - says when it was called
 // 0 - out moving (a - 1 if blocked)
@@ -1954,21 +2013,28 @@ void run_special(pending_special_type spec, short* a, short* b, short* redraw) {
 // start spec - the number of the first spec to call
 // a,b - 2 values that can be returned
 // redraw - 1 if now need redraw
-void run_special(eSpecCtx which_mode,short which_type,short start_spec,location spec_loc,short *a,short *b,short *redraw) {
+// Runs a chain of nodes until it ends, returning true, or stops early. Given a budget,
+// it may also stop once that many nodes have run this tick, leaving the rest paused.
+static bool run_spec_chain(queued_special_t chain, short *a, short *b, short *redraw, int budget) {
+	cSubsystemTimer timer(eSubsystem::SPECIALS);
+	eSpecCtx which_mode = chain.spec.mode;
+	location spec_loc = chain.spec.where;
 	short cur_spec,cur_spec_type,next_spec,next_spec_type;
-	cSpecial cur_node;
+	const cSpecial* node = nullptr;
+	cSpecial resolved;
 	int num_nodes = 0;
+	bool picked_present = false;
 	
-	// Modify this to put a value in the special node queue instead of raising an error
-	if(special_in_progress && start_spec >= 0) {
-		queue_special(which_mode, which_type, start_spec, spec_loc);
-		return;
-	}
 	special_in_progress = true;
-	next_spec = start_spec;
-	next_spec_type = which_type;
+	next_spec = chain.spec.spec;
+	next_spec_type = chain.spec.type;
 	current_pc_picked_in_spec_enc = nullptr;
-	switch(which_mode) {
+	if(chain.picked != size_t(-1)) {
+		// Carrying on from last frame; the monster may have gone since.
+		if(chain.picked <= 6 || (chain.picked >= 100 && chain.picked - 100 < univ.town.monst.size()))
+			current_pc_picked_in_spec_enc = &univ.get_target(chain.picked);
+		else current_pc_picked_in_spec_enc = &univ.party;
+	} else switch(which_mode) {
 		case eSpecCtx::OUT_MOVE: case eSpecCtx::TOWN_MOVE: case eSpecCtx::COMBAT_MOVE:
 		case eSpecCtx::OUT_LOOK: case eSpecCtx::TOWN_LOOK: case eSpecCtx::ENTER_TOWN: case eSpecCtx::LEAVE_TOWN:
 		case eSpecCtx::TALK: case eSpecCtx::USE_SPEC_ITEM: case eSpecCtx::TOWN_HOSTILE:
@@ -1980,9 +2046,10 @@ void run_special(eSpecCtx which_mode,short which_type,short start_spec,location
 			if(is_combat() && !univ.scenario.is_legacy)
 				current_pc_picked_in_spec_enc = &univ.party[current_pc];
 			else {
-				if(univ.party.is_split() && cur_node.type != eSpecType::AFFECT_DEADNESS)
+				if(univ.party.is_split()) {
 					current_pc_picked_in_spec_enc = &univ.party.pc_present();
-				else current_pc_picked_in_spec_enc = &univ.party;
+					picked_present = true;
+				} else current_pc_picked_in_spec_enc = &univ.party;
 			}
 			break;
 		case eSpecCtx::KILL_MONST: case eSpecCtx::SEE_MONST: case eSpecCtx::MONST_SPEC_ABIL:
@@ -2002,27 +2069,43 @@ void run_special(eSpecCtx which_mode,short which_type,short start_spec,location
 	}
 	if(end_scenario) {
 		special_in_progress = false;
-		return;
+		return false;
 	}
 	
-	// Store the special's location in reserved pointers
-	univ.party.force_ptr(10, spec_loc.x);
-	univ.party.force_ptr(11, spec_loc.y);
-	// Also store the terrain type on that location
-	univ.party.force_ptr(12, coord_to_ter(spec_loc.x, spec_loc.y));
-
+	if(chain.picked == size_t(-1)) {
+		// Store the special's location in reserved pointers
+		univ.party.force_ptr(10, spec_loc.x);
+		univ.party.force_ptr(11, spec_loc.y);
+		// Also store the terrain type on that location
+		univ.party.force_ptr(12, coord_to_ter(spec_loc.x, spec_loc.y));
+	}
 	
 	while(next_spec >= 0) {
+		if(budget > 0 && nodes_this_tick >= budget) {
+			// Leave the rest for the next frame, so the game doesn't stop responding.
+			chain.spec.spec = next_spec;
+			chain.spec.type = next_spec_type;
+			chain.picked = current_pc_picked_in_spec_enc ? univ.get_target_i(*current_pc_picked_in_spec_enc) : -1;
+			paused_chain = chain;
+			chain_paused = true;
+			spec_stats.paused++;
+			special_in_progress = false;
+			return false;
+		}
 		
 		cur_spec = next_spec;
 		cur_spec_type = next_spec_type;
 		next_spec = -1;
-		cur_node = get_node(cur_spec,cur_spec_type);
+		node = &get_node(cur_spec,cur_spec_type);
+		// A chain that starts by affecting deadness must be able to reach the PCs that were split off
+		if(picked_present && node->type == eSpecType::AFFECT_DEADNESS)
+			current_pc_picked_in_spec_enc = &univ.party;
+		picked_present = false;
 		
 		if(univ.node_step_through) {
 			give_help(68,69);
 			std::string debug = "Step: ";
-			debug += (*cur_node.type).name();
+			debug += (*node->type).name();
 			debug += " - ";
 			debug += std::to_string(cur_spec);
 			add_string_to_buf(debug);
@@ -2041,67 +2124,37 @@ void run_special(eSpecCtx which_mode,short which_type,short start_spec,location
 		// This is because some nodes now use -2 as a meaningful value. If that's all, then
 		// just disallowing single-digit pointers should suffice, but what about arithmetic?
 		// (Of course, currently all SDFs are positive, so allowing negative arithmetic is useless.)
-		if(cur_node.sd1 <= -10) cur_node.sd1 = univ.party.get_ptr(-cur_node.sd1);
-		if(cur_node.sd2 <= -10) cur_node.sd2 = univ.party.get_ptr(-cur_node.sd2);
-		if(cur_node.m1 <= -10) cur_node.m1 = univ.party.get_ptr(-cur_node.m1);
-		if(cur_node.m2 <= -10) cur_node.m2 = univ.party.get_ptr(-cur_node.m2);
-		if(cur_node.m3 <= -10) cur_node.m3 = univ.party.get_ptr(-cur_node.m3);
-		if(cur_node.pic <= -10) cur_node.pic = univ.party.get_ptr(-cur_node.pic);
-		if(cur_node.pictype <= -10) cur_node.pictype = univ.party.get_ptr(-cur_node.pictype);
-		if(cur_node.ex1a <= -10) cur_node.ex1a = univ.party.get_ptr(-cur_node.ex1a);
-		if(cur_node.ex1b <= -10) cur_node.ex1b = univ.party.get_ptr(-cur_node.ex1b);
-		if(cur_node.ex1c <= -10) cur_node.ex1c = univ.party.get_ptr(-cur_node.ex1c);
-		if(cur_node.ex2a <= -10) cur_node.ex2a = univ.party.get_ptr(-cur_node.ex2a);
-		if(cur_node.ex2b <= -10) cur_node.ex2b = univ.party.get_ptr(-cur_node.ex2b);
-		if(cur_node.ex2c <= -10) cur_node.ex2c = univ.party.get_ptr(-cur_node.ex2c);
-		if(cur_node.jumpto <= -10) cur_node.jumpto = univ.party.get_ptr(-cur_node.jumpto);
+		// Most nodes have no pointers at all, so they run straight from the scenario.
+		if(node->ptr_slots) {
+			resolved = *node;
+			resolved.resolve_pointers(univ.party);
+			node = &resolved;
+		}
+		const cSpecial& cur_node = *node;
 		
 		//print_nums(1111,cur_spec_type,cur_node.type);
 		
-		if(cur_node.type == eSpecType::INVALID) {
+		if(cur_node.category == eSpecCat::INVALID) {
+			// TODO: Should it print some kind of error message?
 			special_in_progress = false;
-			return;
+			return false;
 		}
-		switch(getNodeCategory(cur_node.type)) {
-			case eSpecCat::GENERAL:
-				if(cur_node.type == eSpecType::NONE && univ.debug_mode) {
-					std::string type("???");
-					switch(cur_spec_type) {
-						case 0: type = "scenario"; break;
-						case 1: type = "outdoors" ; break;
-						case 2: type = "town"; break;
-					}
-					add_string_to_buf("Warning: Null " + type + " special called (ID " + std::to_string(cur_spec) + ") - was this intended?", 4);
-				}
-				general_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::ONCE:
-				oneshot_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::AFFECT:
-				affect_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::IF_THEN:
-				ifthen_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::TOWN:
-				townmode_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::RECT:
-				rect_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::OUTDOOR:
-				outdoor_spec(which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
-				break;
-			case eSpecCat::INVALID:
-				// TODO: Should it print some kind of error message?
-				special_in_progress = false;
-				return;
+		if(cur_node.type == eSpecType::NONE && univ.debug_mode) {
+			std::string type("???");
+			switch(cur_spec_type) {
+				case 0: type = "scenario"; break;
+				case 1: type = "outdoors" ; break;
+				case 2: type = "town"; break;
+			}
+			add_string_to_buf("Warning: Null " + type + " special called (ID " + std::to_string(cur_spec) + ") - was this intended?", 4);
 		}
+		spec_handlers[int(cur_node.category)](which_mode,cur_node,cur_spec_type,&next_spec,&next_spec_type,a,b,redraw);
 		
 		num_nodes++;
+		nodes_this_tick++;
 		
-		if(check_for_interrupt()){
+		// Checking the keyboard costs far more than most nodes, so only do it now and then.
+		if(num_nodes % 64 == 0 && check_for_interrupt()){
 			add_string_to_buf("SPECIAL ENCOUNTER INTERRUPTED.", 3);
 			next_spec = -1;
 		}
@@ -2110,18 +2163,74 @@ void run_special(eSpecCtx which_mode,short which_type,short start_spec,location
 		erase_out_specials();
 	else erase_specials();
 	special_in_progress = false;
-	
-	// TODO: Should find a way to do this that doesn't risk stack overflow
-	if(next_spec == -1 && !special_queue.empty()) {
-		pending_special_type pending = special_queue.front();
-		special_queue.pop();
-		run_special(pending, a, b, redraw);
+	return true;
+}
+
+static bool run_queued_chain(const queued_special_t& chain, short *a, short *b, short *redraw, int budget) {
+	unsigned long store_time = univ.party.age;
+	univ.party.age = chain.spec.trigger_time;
+	bool finished = run_spec_chain(chain, a, b, redraw, budget);
+	univ.party.age = std::max(univ.party.age, store_time);
+	return finished;
+}
+
+// Runs through the queue, without recursion, until it's empty or a chain stops early.
+// Replays and simulations have the same budget, so chains pause at the same places there;
+// they just carry on straight away instead of waiting for the next frame.
+static void drain_special_queue(short *a, short *b, short *redraw) {
+	int budget = NODES_PER_TICK;
+	while(!special_in_progress) {
+		queued_special_t chain;
+		if(chain_paused) {
+			chain = paused_chain;
+			chain_paused = false;
+		} else if(!special_queue.empty()) {
+			chain = special_queue.top();
+			special_queue.pop();
+		} else break;
+		if(!run_queued_chain(chain, a, b, redraw, budget))
+			break;
+	}
+}
+
+bool run_queued_specials(short *a, short *b, short *redraw) {
+	drain_special_queue(a, b, redraw);
+	// That's the end of the tick
+	if(nodes_this_tick > 0) {
+		spec_stats.nodes += nodes_this_tick;
+		spec_stats.ticks++;
+		spec_stats.last_tick = nodes_this_tick;
+		spec_stats.peak_tick = std::max(spec_stats.peak_tick, nodes_this_tick);
 	}
+	nodes_this_tick = 0;
+	return chain_paused || !special_queue.empty();
 }
 
-cSpecial get_node(short cur_spec,short cur_spec_type) {
-	cSpecial dummy_node;
+void run_special(eSpecCtx which_mode,short which_type,short start_spec,location spec_loc,short *a,short *b,short *redraw) {
+	if(special_in_progress && start_spec >= 0) {
+		queue_special(which_mode, which_type, start_spec, spec_loc);
+		return;
+	}
+	// Anything left over from last frame goes first, so specials still run in the order they were set off.
+	// This one waits its turn in the queue, so it isn't lost if the paused chain stops early again.
+	if(chain_paused) {
+		queue_special(which_mode, which_type, start_spec, spec_loc);
+		drain_special_queue(a, b, redraw);
+		return;
+	}
+	queued_special_t chain;
+	chain.spec.spec = start_spec;
+	chain.spec.mode = which_mode;
+	chain.spec.type = which_type;
+	chain.spec.where = spec_loc;
+	if(run_spec_chain(chain, a, b, redraw, 0))
+		drain_special_queue(a, b, redraw);
+}
+
+const cSpecial& get_node(short cur_spec,short cur_spec_type) {
+	static cSpecial dummy_node;
 	dummy_node.type = eSpecType::INVALID;
+	dummy_node.compile();
 	if(cur_spec_type == 0) {
 		if(cur_spec != minmax(0,univ.scenario.scen_specials.size() - 1,cur_spec)) {
 			showError("The scenario called a scenario special node out of range.");
@@ -2147,14 +2256,13 @@ cSpecial get_node(short cur_spec,short cur_spec_type) {
 }
 
 // TODO: Make cur_spec_type an enum
-void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void general_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				  short *next_spec,short *next_spec_type,short *a,short *b,short *redraw) {
 	bool check_mess = false;
 	std::string str1,str2;
 	short store_val = 0,i,j;
-	cSpecial spec;
 	
-	spec = cur_node;
+	const cSpecial& spec = cur_node;
 	*next_spec = cur_node.jumpto;
 	
 	switch(cur_node.type) {
@@ -2201,12 +2309,14 @@ void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 			break;
 		case eSpecType::CHANGE_TIME:
 			check_mess = true;
-			univ.party.age += spec.ex1a;
+			univ.party.shift_age(spec.ex1a);
+			reset_timers();
 			// TODO: Should this trigger special events, timers, etc?
 			break;
 		case eSpecType::SCEN_TIMER_START:
 			check_mess = true;
 			univ.party.start_timer(spec.ex1a, spec.ex1b, 0);
+			reload_timers(eTimerKind::PARTY);
 			break;
 		case eSpecType::PLAY_SOUND:
 			if(spec.ex1b)
@@ -2236,8 +2346,10 @@ void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 			check_mess = true;
 			if(spec.ex1a != minmax(1,10,spec.ex1a))
 				showError("Event code out of range.");
-			else if(univ.party.key_times.count(spec.ex1a) == 0)
+			else if(univ.party.key_times.count(spec.ex1a) == 0) {
 				univ.party.key_times[spec.ex1a] = univ.party.calc_day();
+				reload_timers(eTimerKind::QUEST);
+			}
 			break;
 		case eSpecType::FORCED_GIVE:
 			check_mess = true;
@@ -2390,8 +2502,7 @@ void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 			break;
 		case eSpecType::ENTER_SHOP:
 			get_strs(str1,str2,1,spec.m1,-1);
-			spec.ex1b = minmax(0,6,spec.ex2b);
-			start_shop_mode(spec.ex1a, spec.ex1b, str1);
+			start_shop_mode(spec.ex1a, minmax(0,6,spec.ex2b), str1);
 			*next_spec = -1;
 			break;
 		case eSpecType::STORY_DIALOG:
@@ -2476,6 +2587,7 @@ void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 					univ.party.job_banks.resize(univ.party.quest_source[spec.ex1a] + 1);
 			}
 			univ.party.quest_status[spec.ex1a] = eQuestStatus(spec.ex1b);
+			reload_timers(eTimerKind::QUEST);
 			switch(univ.party.quest_status[spec.ex1a]) {
 				case eQuestStatus::STARTED: add_string_to_buf("You have received a quest."); break;
 				case eQuestStatus::AVAILABLE: break; // TODO: Should this award XP/gold if the quest was previously started?
@@ -2527,18 +2639,17 @@ void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
  }
  */
 
-void oneshot_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void oneshot_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				  short* next_spec,short* next_spec_type,short* a,short* b,short* redraw) {
 	bool check_mess = true,set_sd = true;
 	std::array<std::string, 6> strs;
 	short i,j;
 	std::array<short, 3> buttons = {-1,-1,-1};
-	cSpecial spec;
 	cItem store_i;
 	location l;
 	std::string choice;
 	
-	spec = cur_node;
+	const cSpecial& spec = cur_node;
 	*next_spec = cur_node.jumpto;
 	if((univ.party.sd_legit(spec.sd1,spec.sd2)) && (PSD[spec.sd1][spec.sd2] == 250)) {
 		*next_spec = -1;
@@ -2697,16 +2808,15 @@ void oneshot_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 	
 }
 
-void affect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void affect_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				 short *next_spec,short* /*next_spec_type*/,short *a,short *b,short *redraw) {
 	bool check_mess = true;
 	short i,r1;
 	iLiving* pc = current_pc_picked_in_spec_enc;
 	short pc_num = univ.get_target_i(*current_pc_picked_in_spec_enc);
 	std::string str;
-	cSpecial spec;
 	
-	spec = cur_node;
+	const cSpecial& spec = cur_node;
 	*next_spec = cur_node.jumpto;
 	
 	switch(cur_node.type) {
@@ -3251,9 +3361,9 @@ void affect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 				univ.party.new_pc(pc_num);
 			}
 			break;
-		case eSpecType::UNSTORE_PC:
-			if(spec.ex1a < 1000) spec.ex1a += 1000;
-			if(univ.stored_pcs.find(spec.ex1a) == univ.stored_pcs.end()) {
+		case eSpecType::UNSTORE_PC: {
+			long stored_id = spec.ex1a < 1000 ? spec.ex1a + 1000 : spec.ex1a;
+			if(univ.stored_pcs.find(stored_id) == univ.stored_pcs.end()) {
 				showError("Scenario tried to unstore a nonexistent PC!");
 				break;
 			}
@@ -3264,11 +3374,12 @@ void affect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 				check_mess = false;
 				break;
 			}
-			univ.party.replace_pc(pc_num, univ.stored_pcs[spec.ex1a]);
+			univ.party.replace_pc(pc_num, univ.stored_pcs[stored_id]);
 			current_pc_picked_in_spec_enc = &univ.get_target(pc_num);
 			univ.party[pc_num].main_status -= eMainStatus::SPLIT;
-			univ.stored_pcs.erase(spec.ex1a);
+			univ.stored_pcs.erase(stored_id);
 			break;
+		}
 		case eSpecType::AFFECT_MONST_TARG:
 			if(pc_num < 100) break;
 			// TODO: Verify this actually works! It's possible the monster ignores this and just recalculates its target each turn.
@@ -3326,15 +3437,14 @@ static bool isValidField(int fld, bool allowSpecial) {
 	return false;
 }
 
-void ifthen_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void ifthen_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				 short *next_spec,short* /*next_spec_type*/,short *a,short *b,short *redraw) {
 	bool check_mess = false;
 	std::string str1, str2, str3;
 	short i,j,k;
-	cSpecial spec;
 	location l;
 	
-	spec = cur_node;
+	cSpecial spec = cur_node; // A few checks below fix up bad values in their own copy
 	*next_spec = cur_node.jumpto;
 	
 	switch(cur_node.type) {
@@ -3783,7 +3893,7 @@ void ifthen_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 	}
 }
 
-void townmode_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void townmode_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				   short *next_spec,short* /*next_spec_type*/,short *a,short *b,short *redraw) {
 	static const char*const stairDlogs[8] = {
 		"basic-stair-up", "basic-stair-down",
@@ -3795,13 +3905,12 @@ void townmode_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 	std::array<std::string, 6> strs;
 	short i,r1;
 	std::array<short,3> buttons = {-1,-1,-1};
-	cSpecial spec;
 	location l;
 	ter_num_t ter;
 	cItem store_i;
 	effect_pat_type pat;
 	
-	spec = cur_node;
+	cSpecial spec = cur_node; // Stairs and relocation adjust their modes in this copy
 	*next_spec = cur_node.jumpto;
 	
 	l.x = spec.ex1a; l.y = spec.ex1b;
@@ -4149,6 +4258,7 @@ void townmode_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 			break;
 		case eSpecType::TOWN_TIMER_START:
 			univ.party.start_timer(spec.ex1a, spec.ex1b, 2);
+			reload_timers(eTimerKind::PARTY);
 			break;
 			// OBoE: Change town lighting
 		case eSpecType::TOWN_CHANGE_LIGHTING:
@@ -4389,15 +4499,14 @@ void townmode_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
 	}
 }
 
-void rect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void rect_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 			   short *next_spec,short* /*next_spec_type*/,short *a,short *b,short *redraw){
 	bool check_mess = true;
 	short i,j,k;
-	cSpecial spec;
 	location l;
 	ter_num_t ter;
 	
-	spec = cur_node;
+	const cSpecial& spec = cur_node;
 	*next_spec = cur_node.jumpto;
 	
 	*redraw = 1;
@@ -4530,15 +4639,14 @@ END:
 	}
 }
 
-void outdoor_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void outdoor_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 				  short *next_spec,short* /*next_spec_type*/,short *a,short *b,short *redraw){
 	bool check_mess = false;
 	std::string str1, str2;
-	cSpecial spec;
 	location l;
 	int i;
 	
-	spec = cur_node;
+	const cSpecial& spec = cur_node;
 	*next_spec = cur_node.jumpto;
 	
 	if(!is_out()) return;
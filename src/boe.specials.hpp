@@ -21,24 +21,39 @@ void change_level(short town_num,short x,short y);
 void push_things();
 void queue_special(eSpecCtx mode, unsigned short which_type, short spec, location spec_loc);
 void run_special(eSpecCtx which_mode,short which_type,short start_spec,location spec_loc,short *a,short *b,short *redraw);
-void run_special(pending_special_type spec, short* a, short* b, short* redraw);
-cSpecial get_node(short cur_spec,short cur_spec_type);
-void general_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+// Runs queued specials, most urgent first, within the node budget for this tick.
+// Returns true if any are left for later.
+bool run_queued_specials(short* a, short* b, short* redraw);
+// True if a chain ran out of nodes for the last tick and should carry on this frame
+bool special_chain_paused();
+void clear_special_queue();
+
+// How many special nodes have run, for profiling. A tick is one action or one frame.
+struct special_stats_t {
+	long long nodes = 0;
+	long ticks = 0; // Only those in which any nodes ran
+	int last_tick = 0, peak_tick = 0;
+	long paused = 0; // Chains put off until the next frame
+	long dropped = 0; // Specials that didn't fit in the queue
+};
+const special_stats_t& special_stats();
+const cSpecial& get_node(short cur_spec,short cur_spec_type);
+void general_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
 void setsd(short a,short b,short val);
 void handle_message(eSpecCtx which_mode,short cur_type,short mess1,short mess2,short*a,short*b,std::string title="",pic_num_t pic=-1,ePicType pt=PIC_SCEN);
 void get_strs(std::string& str1, std::string& str2,short cur_type,short which_str1,short which_str2) ;
-void ifthen_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void ifthen_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
-void affect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void affect_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
-void oneshot_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void oneshot_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
-void townmode_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void townmode_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
-void rect_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void rect_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
-void outdoor_spec(eSpecCtx which_mode,cSpecial cur_node,short cur_spec_type,
+void outdoor_spec(eSpecCtx which_mode,const cSpecial& cur_node,short cur_spec_type,
 	short *next_spec,short *next_spec_type,short *a,short *b,short *redraw);
 
 void set_campaign_flag(short sdf_a, short sdf_b, short cpf_a, short cpf_b, short str, bool get_send);
@@ -48,7 +48,7 @@ bool handle_startup_press(location the_point) {
 		if(the_point.in(startup_button[i])) {
 			draw_start_button(i,5);
 			mainPtr.display(); // TODO: I suspect this won't work
-			play_sound(37, time_in_ticks(5));
+			play_sound(37);
 			draw_start_button(i,0);
 			switch(i) {
 				case STARTBTN_LOAD:
@@ -149,11 +149,14 @@ void show_logo() {
 	sf::Texture& pict_to_draw = *ResMgr::get<ImageRsrc>("spidlogo");
 	from_rect = rectangle(pict_to_draw);
 	
-	play_sound(-95);
-	// TODO: Looping 10 times here is a bit of a hack; fix it
-	while(sound_going(95)) {
+	bool sound_done = false;
+	play_sound(95, eSndPriority::NORMAL, [&sound_done]() {
+		sound_done = true;
+	});
+	while(!sound_done) {
 		draw_splash(pict_to_draw, mainPtr, logo_from);
 		handle_splash_events();
+		update_sounds();
 	}
 	if(!get_int_pref("ShowStartupSplash", true)) {
 		sf::Time delay = time_in_ticks(60);
@@ -19,7 +19,14 @@ typedef struct {
 	char line[50];
 } buf_line;
 
+// A ring of lines; buf_pointer is where the next one goes.
 buf_line text_buffer[TEXT_BUF_LEN];
+// Each line is laid out once, the first time it's drawn after it changes.
+static sf::Text buf_layout[TEXT_BUF_LEN];
+static bool buf_laid_out[TEXT_BUF_LEN];
+// And the transcript is only redrawn if a line changed or it was scrolled.
+static bool buf_changed = true;
+static long last_print_point = -1;
 short buf_pointer = 30, lines_to_print= 0, num_added_since_stop = 0;
 short start_print_point= 0;
 short mark_where_printing_long;
@@ -37,6 +44,7 @@ rectangle item_buttons_from[7] = {
 eGameMode store_mode;
 
 extern short had_text_freeze;
+extern bool headless;
 extern eStatMode stat_screen_mode;
 
 // graphics globals
@@ -56,6 +64,7 @@ extern location center;
 extern cCustomGraphics spec_scen_g;
 extern sf::RenderTexture pc_stats_gworld, item_stats_gworld, text_area_gworld;
 extern sf::RenderTexture terrain_screen_gworld;
+extern cSpriteBatch terrain_batch;
 
 // game globals
 extern location ul;
@@ -90,6 +99,7 @@ void put_pc_screen() {
 	rectangle bottom_bar_rect = {99,0,116,271};
 	rectangle info_from = {0,1,12,13};
 	
+	if(headless) return;
 	pc_stats_gworld.setActive();
 	
 	// First clean up gworld with pretty patterns
@@ -225,6 +235,7 @@ void put_item_screen(short screen_num) {
 	rectangle erase_rect = {17,2,122,255},dest_rect;
 	rectangle upper_frame_rect = {3,3,15,268};
 	
+	if(headless) return;
 	item_stats_gworld.setActive();
 	
 	// First clean up gworld with pretty patterns
@@ -663,7 +674,6 @@ void draw_pc_effects(short pc) {
 	if(exceptSplit(univ.party[pc].main_status) != eMainStatus::ALIVE)
 		return;
 	
-	univ.party[pc].status[eStatus::HASTE_SLOW]; // This just makes sure it exists in the map, without changing its value if it does
 	sf::Texture& status_gworld = *ResMgr::get<ImageRsrc>("staticons");
 	for(auto next : univ.party[pc].status) {
 		short placedIcon = -1;
@@ -1057,6 +1067,8 @@ void add_string_to_buf(std::string str, unsigned short indent) {
 				sscanf(text_buffer[prev_pointer].line + num_pos, "%d", &lastCount);
 			
 			sprintf(text_buffer[prev_pointer].line + last, " (x%d)", lastCount + 1);
+			buf_laid_out[prev_pointer] = false;
+			buf_changed = true;
 			return;
 		}
 	}
@@ -1064,11 +1076,14 @@ void add_string_to_buf(std::string str, unsigned short indent) {
 	text_sbar->setPosition(58); // TODO: This seems oddly specific
 	if(buf_pointer == mark_where_printing_long) {
 		printing_long = true;
+		buf_changed = true;
 		print_buf();
 		through_sending();
 	}
 	sprintf((char *)text_buffer[buf_pointer].line, "%-49.49s", str.c_str());
 //	c2pstr((char *)text_buffer[buf_pointer].line);
+	buf_laid_out[buf_pointer] = false;
+	buf_changed = true;
 	if(buf_pointer == (TEXT_BUF_LEN - 1))
 		buf_pointer = 0;
 	else buf_pointer++;
@@ -1080,6 +1095,8 @@ void init_buf() {
 	
 	for(i = 0; i < TEXT_BUF_LEN; i++)
 		sprintf((char *) text_buffer[buf_pointer].line, " ");
+	buf_laid_out[buf_pointer] = false;
+	buf_changed = true;
 }
 
 void print_buf () {
@@ -1090,22 +1107,35 @@ void print_buf () {
 	bool end_loop = false;
 	rectangle store_text_rect,dest_rect,erase_rect = {2,2,136,255};
 	
-	text_area_gworld.setActive();
-	
-	// First clean up gworld with pretty patterns
-	tileImage(text_area_gworld, erase_rect,bg[6]);
+	if(headless) return;
 	
 	ctrl_val = 58 - text_sbar->getPosition();
 	start_print_point = buf_pointer - LINES_IN_TEXT_WIN - ctrl_val;
 	if(start_print_point< 0)
 		start_print_point= TEXT_BUF_LEN + start_print_point;
+	if(!buf_changed && start_print_point == last_print_point)
+		return;
+	buf_changed = false;
+	last_print_point = start_print_point;
 	line_to_print= start_print_point;
 	
+	text_area_gworld.setActive();
+	
+	// First clean up gworld with pretty patterns
+	tileImage(text_area_gworld, erase_rect,bg[6]);
+	
 	location moveTo;
 	while((line_to_print!= buf_pointer) && (num_lines_printed < LINES_IN_TEXT_WIN)) {
 		moveTo = location(4, 1 + 12 * num_lines_printed);
-		sf::Text text(text_buffer[line_to_print].line, *ResMgr::get<FontRsrc>("plain"), 12);
-		text.setColor(sf::Color::Black);
+		sf::Text& text = buf_layout[line_to_print];
+		if(!buf_laid_out[line_to_print]) {
+			text.setString(text_buffer[line_to_print].line);
+			text.setFont(*ResMgr::get<FontRsrc>("plain"));
+			text.setCharacterSize(12);
+			text.setColor(sf::Color::Black);
+			buf_laid_out[line_to_print] = true;
+		}
+		// Scrolling only moves the lines
 		text.setPosition(moveTo);
 		text_area_gworld.draw(text);
 		num_lines_printed++;
@@ -1137,6 +1167,8 @@ void through_sending() {
 	mark_where_printing_long = buf_pointer + LINES_IN_TEXT_WIN - 1;
 	if(mark_where_printing_long > TEXT_BUF_LEN - 1)
 		mark_where_printing_long -= TEXT_BUF_LEN;
+	if(printing_long)
+		buf_changed = true;
 	printing_long = false;
 }
 
@@ -1156,12 +1188,12 @@ void Draw_Some_Item (sf::Texture& src_gworld, rectangle src_rect, sf::RenderTarg
 	
 	if(main_win == 0) {
 		if(masked == 1)
-			rect_draw_some_item(src_gworld, src_rect, targ_gworld, destrec, sf::BlendAlpha);
-		else rect_draw_some_item(src_gworld, src_rect, targ_gworld, destrec, sf::BlendNone);
+			terrain_batch.draw(src_gworld, src_rect, targ_gworld, destrec, sf::BlendAlpha);
+		else terrain_batch.draw(src_gworld, src_rect, targ_gworld, destrec, sf::BlendNone);
 	} else {
 		if(masked == 1)
-			rect_draw_some_item(src_gworld, src_rect, targ_gworld, destrec, sf::BlendAlpha);
-		else rect_draw_some_item(src_gworld, src_rect, targ_gworld, destrec, sf::BlendNone);
+			terrain_batch.draw(src_gworld, src_rect, targ_gworld, destrec, sf::BlendAlpha);
+		else terrain_batch.draw(src_gworld, src_rect, targ_gworld, destrec, sf::BlendNone);
 	}
 }
 
@@ -0,0 +1,151 @@
+//
+//  boe.timers.cpp
+//  BoE
+//
+//  Keeps the party, town and scenario timers and the quest deadlines in order of when they
+//  next go off, so passing time only costs anything for the ones that do.
+//
+
+#include "boe.global.hpp"
+#include "universe.hpp"
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "boe.timers.hpp"
+
+extern cUniverse univ;
+
+static const int NUM_KINDS = int(eTimerKind::PARTY) + 1;
+
+// An entry whose epoch is out of date was replaced when its kind was reloaded, and is skipped.
+static std::priority_queue<timer_event_t, std::vector<timer_event_t>, std::greater<timer_event_t>> timers;
+static unsigned int epoch[NUM_KINDS];
+static bool built = false;
+static short timers_town = -1;
+
+bool timer_event_t::operator>(const timer_event_t& other) const {
+	if(when != other.when)
+		return when > other.when;
+	if(kind != other.kind)
+		return kind > other.kind;
+	return which > other.which;
+}
+
+// The first multiple of period after age
+static unsigned long next_multiple(unsigned long age, long period) {
+	return (age / period + 1) * period;
+}
+
+static const cTimer& periodic_timer(eTimerKind kind, size_t which) {
+	if(kind == eTimerKind::TOWN)
+		return univ.town->timers[which];
+	return univ.scenario.scenario_timers[which];
+}
+
+// The age at which day_reached would first say the quest's deadline has passed.
+// False if it can't pass yet, because the event it depends on hasn't happened.
+static bool quest_deadline(int which, unsigned long& when) {
+	cQuest& quest = univ.scenario.quests[which];
+	if(quest.deadline <= 0)
+		return false;
+	bool is_relative = quest.flags % 10;
+	unsigned short day = quest.deadline + is_relative * univ.party.quest_start[which] + 1;
+	if(univ.party.easy_mode) day += 10;
+	// As unsigned, the same as day_reached takes it
+	unsigned short event = quest.event;
+	if(event > 0) {
+		auto key = univ.party.key_times.find(event);
+		if(key == univ.party.key_times.end() || key->second < day)
+			return false;
+	}
+	// calc_day() is age / 3700 + 1
+	when = day > 0 ? (day - 1) * 3700ul : 0;
+	return true;
+}
+
+static void push_timer(unsigned long when, eTimerKind kind, size_t which) {
+	timers.push({when, kind, which, epoch[int(kind)]});
+}
+
+static void load_timers(eTimerKind kind, unsigned long after) {
+	epoch[int(kind)]++;
+	switch(kind) {
+		case eTimerKind::QUEST:
+			for(auto& p : univ.party.quest_status) {
+				unsigned long when;
+				if(p.second == eQuestStatus::STARTED && quest_deadline(p.first, when))
+					push_timer(when, kind, p.first);
+			}
+			break;
+		case eTimerKind::TOWN:
+			if(timers_town < 0) break;
+			for(size_t i = 0; i < univ.town->timers.size(); i++)
+				if(univ.town->timers[i].time > 0)
+					push_timer(next_multiple(after, univ.town->timers[i].time), kind, i);
+			break;
+		case eTimerKind::SCENARIO:
+			for(size_t i = 0; i < univ.scenario.scenario_timers.size(); i++)
+				if(univ.scenario.scenario_timers[i].time > 0)
+					push_timer(next_multiple(after, univ.scenario.scenario_timers[i].time), kind, i);
+			break;
+		case eTimerKind::PARTY:
+			for(size_t i = 0; i < univ.party.party_event_timers.size(); i++)
+				if(univ.party.party_event_timers[i].node >= 0)
+					push_timer(univ.party.party_event_timers[i].time, kind, i);
+			break;
+	}
+}
+
+void prepare_timers(unsigned long after, short town) {
+	size_t expected = univ.party.quest_status.size() + univ.scenario.scenario_timers.size();
+	expected += univ.party.party_event_timers.size();
+	if(town >= 0)
+		expected += univ.town->timers.size();
+	// By now it's mostly entries that were replaced
+	if(built && timers.size() > 4 * expected + 64)
+		built = false;
+	if(!built) {
+		timers = decltype(timers)();
+		timers_town = town;
+		for(int i = 0; i < NUM_KINDS; i++)
+			load_timers(eTimerKind(i), after);
+		built = true;
+	} else if(town != timers_town) {
+		timers_town = town;
+		load_timers(eTimerKind::TOWN, after);
+	}
+}
+
+bool next_timer(unsigned long after, unsigned long age, timer_event_t& event) {
+	while(!timers.empty() && timers.top().when <= age) {
+		event = timers.top();
+		timers.pop();
+		if(event.epoch != epoch[int(event.kind)])
+			continue;
+		if(event.kind == eTimerKind::TOWN || event.kind == eTimerKind::SCENARIO) {
+			long period = periodic_timer(event.kind, event.which).time;
+			// Time that went by without being passed (such as while away from the town) doesn't count.
+			bool fires = event.when > after;
+			push_timer(fires ? event.when + period : next_multiple(after, period), event.kind, event.which);
+			if(!fires) continue;
+		}
+		return true;
+	}
+	return false;
+}
+
+void reload_timers(eTimerKind kind) {
+	if(!built) return;
+	if(kind == eTimerKind::QUEST || kind == eTimerKind::PARTY)
+		load_timers(kind, 0);
+	else built = false;
+}
+
+void reset_timers() {
+	built = false;
+	// So that anything still being gone through is dropped too
+	for(int i = 0; i < NUM_KINDS; i++)
+		epoch[i]++;
+}
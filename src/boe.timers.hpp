@@ -0,0 +1,34 @@
+//
+//  boe.timers.hpp
+//  BoE
+//
+//  Keeps the party, town and scenario timers and the quest deadlines in order of when they
+//  next go off, so passing time only costs anything for the ones that do.
+//
+
+#ifndef BOE_GAME_TIMERS_H
+#define BOE_GAME_TIMERS_H
+
+#include <cstddef>
+
+// Timers that go off at the same time do so in this order.
+enum class eTimerKind {QUEST, TOWN, SCENARIO, PARTY};
+
+struct timer_event_t {
+	unsigned long when;
+	eTimerKind kind;
+	size_t which; // Index of the timer, or the quest number
+	unsigned int epoch;
+	bool operator>(const timer_event_t& other) const;
+};
+
+// Starts keeping count from after; town is the town whose timers are running, or -1.
+void prepare_timers(unsigned long after, short town);
+// Takes the next timer that goes off after the given age and no later than age.
+bool next_timer(unsigned long after, unsigned long age, timer_event_t& event);
+// Call after changing the party's timers or anything that decides when a quest fails.
+void reload_timers(eTimerKind kind);
+// Call after loading a game or changing the age in any way other than passing time.
+void reset_timers();
+
+#endif
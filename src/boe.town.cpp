@@ -1,6 +1,8 @@
 
 #include <cstdio>
 #include <queue>
+#include <sstream>
+#include <algorithm>
 
 #include "boe.global.hpp"
 
@@ -23,6 +25,7 @@
 #include "boe.infodlg.hpp"
 #include "mathutil.hpp"
 #include "boe.main.hpp"
+#include "boe.timers.hpp"
 #include "graphtool.hpp"
 #include "strdlog.hpp"
 #include "fileio.hpp"
@@ -35,7 +38,6 @@ extern location center;
 extern sf::RenderWindow mainPtr;
 extern short store_current_pc,current_ground;
 extern eGameMode store_pre_shop_mode,store_pre_talk_mode;
-extern std::queue<pending_special_type> special_queue;
 
 extern bool map_visible;
 extern sf::RenderWindow mini_map;
@@ -126,16 +128,17 @@ void start_town_mode(short which_town, short entry_dir) {
 	
 	univ.town.belt_present = false;
 	// Set up map, using stored map
+	ter_view_t town_ter = univ.town->terrain_view();
 	for(i = 0; i < univ.town->max_dim(); i++)
 		for(j = 0; j < univ.town->max_dim(); j++) {
-			if(univ.town_maps[univ.town.num][i / 8][j] & (char)(1 << i % 8))
+			if(univ.town_maps.isExplored(univ.town.num,i,j))
 				make_explored(i,j);
 			
-			if(univ.town->terrain(i,j) == 0)
+			if(town_ter(i,j) == 0)
 				current_ground = 0;
-			else if(univ.town->terrain(i,j) == 2)
+			else if(town_ter(i,j) == 2)
 				current_ground = 2;
-			if(univ.scenario.ter_types[univ.town->terrain(i,j)].special == eTerSpec::CONVEYOR)
+			if(univ.scenario.ter_types[town_ter(i,j)].special == eTerSpec::CONVEYOR)
 				univ.town.belt_present = true;
 		}
 	
@@ -233,7 +236,7 @@ void start_town_mode(short which_town, short entry_dir) {
 					// except that pushable things restore to orig locs
 					temp = univ.party.setup[i][j][k] << 8;
 					temp &= ~(OBJECT_CRATE | OBJECT_BARREL | OBJECT_BLOCK);
-					univ.town.fields[j][k] |= temp;
+					univ.town.set_fields(j, k, univ.town.get_fields(j,k) | temp);
 				}
 		}
 	
@@ -372,7 +375,7 @@ void start_town_mode(short which_town, short entry_dir) {
 	
 	for(i = 0; i < univ.town->preset_items.size(); i++)
 		if((univ.town->preset_items[i].code >= 0)
-			&& (((univ.party.item_taken[univ.town.num][i / 8] & (1 << i % 8)) == 0) ||
+			&& ((i >= 64 || !univ.party.item_taken[univ.town.num][i]) ||
 			(univ.town->preset_items[i].always_there))) {
 				j = univ.town.items.size();
 				// place the preset item, if party hasn't gotten it already
@@ -541,14 +544,14 @@ location end_town_mode(short switching_level,location destination) { // returns
 				univ.party.creature_save[i] = univ.town.monst;
 				for(j = 0; j < univ.town->max_dim(); j++)
 					for(k = 0; k < univ.town->max_dim(); k++)
-						univ.party.setup[i][j][k] = (univ.town.fields[j][k] & 0xff00) >> 8;
+						univ.party.setup[i][j][k] = (univ.town.get_fields(j,k) & 0xff00) >> 8;
 				data_saved = true;
 			}
 		if(!data_saved) {
 			univ.party.creature_save[univ.party.at_which_save_slot] = univ.town.monst;
 			for(j = 0; j < univ.town->max_dim(); j++)
 				for(k = 0; k < univ.town->max_dim(); k++)
-					univ.party.setup[univ.party.at_which_save_slot][j][k] = (univ.town.fields[j][k] & 0xff00) >> 8;
+					univ.party.setup[univ.party.at_which_save_slot][j][k] = (univ.town.get_fields(j,k) & 0xff00) >> 8;
 			univ.party.at_which_save_slot = (univ.party.at_which_save_slot == 3) ? 0 : univ.party.at_which_save_slot + 1;
 		}
 		
@@ -569,16 +572,15 @@ location end_town_mode(short switching_level,location destination) { // returns
 		// Now store map
 		for(i = 0; i < univ.town->max_dim(); i++)
 			for(j = 0; j < univ.town->max_dim(); j++)
-				if(is_explored(i,j)) {
-					univ.town_maps[univ.town.num][i / 8][j] = univ.town_maps[univ.town.num][i / 8][j] |
-					(char) (1 << i % 8);
-				}
+				if(is_explored(i,j))
+					univ.town_maps.explore(univ.town.num,i,j);
 		
 		to_return = univ.party.p_loc;
 		
 		erase_if(univ.party.party_event_timers, [](const cTimer& t) {
 			return t.node_type == 2;
 		});
+		reload_timers(eTimerKind::PARTY);
 		
 	}
 	
@@ -629,14 +631,14 @@ location end_town_mode(short switching_level,location destination) { // returns
 		univ.party.status[ePartyStatus::STEALTH] = 0;
 		univ.party.status[ePartyStatus::DETECT_LIFE] = 0; // TODO: Yes? No? Maybe?
 		for(i = 0; i < 6; i++)
-			erase_if(univ.party[i].status, [](std::pair<const eStatus, short> kv) -> bool {
-				if(kv.first == eStatus::POISON) return false;
-				if(kv.first == eStatus::DISEASE) return false;
-				if(kv.first == eStatus::DUMB) return false;
+			for(auto kv : univ.party[i].status) {
+				if(kv.first == eStatus::POISON) continue;
+				if(kv.first == eStatus::DISEASE) continue;
+				if(kv.first == eStatus::DUMB) continue;
 				if(kv.first == eStatus::ACID && kv.second > 2)
-					return false;
-				return true;
-			});
+					continue;
+				univ.party[i].status[kv.first] = 0;
+			}
 		
 		
 		update_explored(to_return);
@@ -935,9 +937,9 @@ void create_out_combat_terrain(short ter_type,short num_walls,bool is_road) {
 		return;
 	}
 	
+	univ.town.clear_fields();
 	for(i = 0; i < 48; i++)
 		for(j = 0; j < 48; j++) {
-			univ.town.fields[i][j] = 0;
 			if((j <= 8) || (j >= 35) || (i <= 8) || (i >= 35))
 				univ.town->terrain(i,j) = 90;
 			else univ.town->terrain(i,j) = ter_base[arena];
@@ -1304,6 +1306,122 @@ void erase_out_specials() {
 			}
 }
 
+// What map_gworld last showed in each space, so that a refresh only has to draw
+// the spaces that have been explored or changed terrain since.
+struct map_cell_t {
+	bool explored = false, road = false;
+	ter_num_t ter = 0;
+	pic_num_t picture = 0, map_pic = 0;
+	bool operator==(const map_cell_t& other) const {
+		return explored == other.explored && road == other.road && ter == other.ter
+			&& picture == other.picture && map_pic == other.map_pic;
+	}
+	bool operator!=(const map_cell_t& other) const {
+		return !(*this == other);
+	}
+};
+static map_cell_t map_cells[64][64];
+// Which town or outdoor sector map_cells holds; when it changes the map is drawn from scratch.
+static std::string map_cells_key;
+
+static void draw_map_cell(location where, const map_cell_t& cell) {
+	rectangle draw_rect = {0,0,6,6}, custom_from, ter_temp_from = {0,0,12,12};
+	draw_rect.offset(6 * where.x, 6 * where.y);
+	fill_rect(map_gworld, draw_rect, sf::Color::Black);
+	if(!cell.explored) return;
+	
+	pic_num_t pic = cell.map_pic;
+	bool drawLargeIcon = false;
+	if(pic == NO_PIC) {
+		pic = cell.picture;
+		drawLargeIcon = true;
+	}
+	if(pic >= 1000) {
+		if(spec_scen_g) {
+			sf::Texture* src_gw;
+			if(drawLargeIcon) {
+				pic = pic % 1000;
+				graf_pos_ref(src_gw, custom_from) = spec_scen_g.find_graphic(pic);
+				rect_draw_some_item(*src_gw,custom_from,map_gworld,draw_rect);
+			} else {
+				graf_pos_ref(src_gw, custom_from) = spec_scen_g.find_graphic(pic % 1000);
+				custom_from.right = custom_from.left + 12;
+				custom_from.bottom = custom_from.top + 12;
+				pic /= 1000; pic--;
+				custom_from.offset((pic / 3) * 12, (pic % 3) * 12);
+				rect_draw_some_item(*src_gw, custom_from, map_gworld, draw_rect);
+			}
+		}
+	} else if(drawLargeIcon) {
+		if(pic >= 960) {
+			custom_from = calc_rect(4 * ((pic - 960) / 5),(pic - 960) % 5);
+			rect_draw_some_item(*ResMgr::get<ImageRsrc>("teranim"), custom_from, map_gworld, draw_rect);
+		} else {
+			int which_sheet = pic / 50;
+			sf::Texture* src_gw = ResMgr::get<ImageRsrc>("ter" + std::to_string(1 + which_sheet)).get();
+			pic %= 50;
+			custom_from = calc_rect(pic % 10, pic / 10);
+			rect_draw_some_item(*src_gw, custom_from, map_gworld, draw_rect);
+		}
+	} else {
+		if(cell.picture < 960)
+			ter_temp_from.offset(12 * (cell.picture % 20), 12 * (cell.picture / 20));
+		else ter_temp_from.offset(12 * 20, 12 * (cell.picture - 960));
+		rect_draw_some_item(*ResMgr::get<ImageRsrc>("termap"),ter_temp_from,map_gworld,draw_rect);
+	}
+	
+	if(cell.road) {
+		draw_rect.inset(1,1);
+		rect_draw_some_item(*ResMgr::get<ImageRsrc>("trim"),{8,112,12,116},map_gworld,draw_rect);
+	}
+}
+
+// Brings map_gworld up to date with the current town or outdoor sector.
+// Only spaces that differ from what was drawn last time are drawn again,
+// so walking around with the map open costs next to nothing.
+static void update_map_gworld(bool out_mode) {
+	map_gworld.setActive();
+	std::ostringstream key;
+	key << univ.party.scen_name << ' ';
+	if(out_mode)
+		key << "out " << univ.party.outdoor_corner.x << ' ' << univ.party.outdoor_corner.y << ' ' << univ.party.i_w_c.x << ' ' << univ.party.i_w_c.y;
+	else key << "town " << univ.town.num;
+	if(key.str() != map_cells_key) {
+		map_cells_key = key.str();
+		std::fill(&map_cells[0][0], &map_cells[0][0] + 64 * 64, map_cell_t());
+		fill_rect(map_gworld, rectangle(map_gworld), sf::Color::Black);
+	}
+	
+	short size = out_mode ? 48 : univ.town->max_dim();
+	location where;
+	bool changed = false;
+	for(where.x = 0; where.x < size; where.x++)
+		for(where.y = 0; where.y < size; where.y++) {
+			map_cell_t cell;
+			if(out_mode)
+				cell.explored = univ.out.out_e[where.x + 48 * univ.party.i_w_c.x][where.y + 48 * univ.party.i_w_c.y];
+			else cell.explored = is_explored(where.x,where.y);
+			if(cell.explored) {
+				if(out_mode) {
+					cell.ter = univ.out[where.x + 48 * univ.party.i_w_c.x][where.y + 48 * univ.party.i_w_c.y];
+					cell.road = univ.out->roads[where.x][where.y];
+				} else {
+					cell.ter = univ.town->terrain(where.x,where.y);
+					cell.road = univ.town.is_road(where.x,where.y);
+				}
+				cell.picture = univ.scenario.ter_types[cell.ter].picture;
+				cell.map_pic = univ.scenario.ter_types[cell.ter].map_pic;
+			}
+			map_cell_t& drawn = map_cells[where.x][where.y];
+			if(cell == drawn) continue;
+			drawn = cell;
+			draw_map_cell(where, cell);
+			changed = true;
+		}
+	if(changed)
+		map_gworld.display();
+}
+
 // TODO: I don't think we need this
 void clear_map() {
 	rectangle map_world_rect(map_gworld);
@@ -1314,34 +1432,26 @@ void clear_map() {
 //	draw_map(mini_map,11);
 	
 	fill_rect(map_gworld, map_world_rect, sf::Color::Black);
-	
+	// Nothing is drawn any more, so the next refresh has to draw everything.
+	map_cells_key.clear();
 }
 
 void draw_map(bool need_refresh) {
 	if(!map_visible) return;
 	short i;
-	pic_num_t pic;
-	rectangle the_rect,map_world_rect = {0,0,384,384};
+	rectangle the_rect;
 	location where;
-	location kludge;
-	rectangle draw_rect,orig_draw_rect = {0,0,6,6},ter_temp_from,base_source_rect = {0,0,12,12};
+	rectangle draw_rect;
 	rectangle	dlogpicrect = {6,6,42,42};
-	bool draw_pcs = true,out_mode;
-	rectangle view_rect= {0,0,48,48},tiny_rect = {0,0,32,32},
-	redraw_rect = {0,0,48,48},big_rect = {0,0,64,64}; // Rectangle visible in view screen
+	bool draw_pcs = true;
+	rectangle view_rect= {0,0,48,48},tiny_rect = {0,0,32,32}; // Rectangle visible in view screen
 	
 	rectangle area_to_draw_from,area_to_draw_on = {29,47,269,287};
-	ter_num_t what_ter;
-	bool draw_surroundings = false,expl;
-	short total_size = 48; // if full redraw, use this to figure out everything
-	rectangle custom_from;
-	
-	draw_surroundings = true;
 	
 	town_map_adj.x = 0;
 	town_map_adj.y = 0;
 	
-	// view rect is rect that is visible, redraw rect is area to redraw now
+	// view rect is rect that is visible
 	// area_to_draw_from is final draw from rect
 	// area_to_draw_on is final draw to rect
 	// extern short store_pre_shop_mode,store_pre_talk_mode;
@@ -1352,28 +1462,23 @@ void draw_map(bool need_refresh) {
 		view_rect.right = view_rect.left + 40;
 		view_rect.top = minmax(0,8,univ.party.loc_in_sec.y - 20);
 		view_rect.bottom = view_rect.top + 40;
-		redraw_rect = view_rect;
 	}
 	else {
-		total_size = univ.town->max_dim();
-		switch(total_size) {
+		switch(univ.town->max_dim()) {
 			case 64:
 				view_rect.left = minmax(0,24,univ.town.p_loc.x - 20);
 				view_rect.right = view_rect.left + 40;
 				view_rect.top = minmax(0,24,univ.town.p_loc.y - 20);
 				view_rect.bottom = view_rect.top + 40;
-				redraw_rect = big_rect;
 				break;
 			case 48:
 				view_rect.left = minmax(0,8,univ.town.p_loc.x - 20);
 				view_rect.right = view_rect.left + 40;
 				view_rect.top = minmax(0,8,univ.town.p_loc.y - 20);
 				view_rect.bottom = view_rect.top + 40;
-				redraw_rect = view_rect;
 				break;
 			case 32:
 				view_rect = tiny_rect;
-				redraw_rect = view_rect;
 				break;
 		}
 	}
@@ -1403,91 +1508,9 @@ void draw_map(bool need_refresh) {
 		title_string = "This place defies mapping.";
 		canMap = false;
 	}
-	else if(need_refresh) {
-		map_gworld.setActive();
-		
-		fill_rect(map_gworld, map_world_rect, sf::Color::Black);
-		
-		// Now, if shopping or talking, just don't touch anything.
-		if((overall_mode == MODE_SHOPPING) || (overall_mode == MODE_TALKING))
-			redraw_rect.right = -1;
-		
-		if((is_out()) ||
-			((is_combat()) && (which_combat_type == 0)) ||
-			((overall_mode == MODE_TALKING) && (store_pre_talk_mode == 0)) ||
-			((overall_mode == MODE_SHOPPING) && (store_pre_shop_mode == 0)))
-			out_mode = true;
-		else out_mode = false;
-		
-		// TODO: It could be possible to draw the entire map here and then only refresh if a spot actually changes terrain type
-		sf::Texture& small_ter_gworld = *ResMgr::get<ImageRsrc>("termap");
-		for(where.x = redraw_rect.left; where.x < redraw_rect.right; where.x++)
-			for(where.y = redraw_rect.top; where.y < redraw_rect.bottom; where.y++) {
-				draw_rect = orig_draw_rect;
-				draw_rect.offset(6 * where.x, 6 * where.y);
-				
-				if(out_mode)
-					what_ter = univ.out[where.x + 48 * univ.party.i_w_c.x][where.y + 48 * univ.party.i_w_c.y];
-				else what_ter = univ.town->terrain(where.x,where.y);
-				
-				ter_temp_from = base_source_rect;
-				
-				if(out_mode)
-					expl = univ.out.out_e[where.x + 48 * univ.party.i_w_c.x][where.y + 48 * univ.party.i_w_c.y];
-				else expl = is_explored(where.x,where.y);
-				
-				if(expl != 0) {
-					pic = univ.scenario.ter_types[what_ter].map_pic;
-					bool drawLargeIcon = false;
-					if(pic == NO_PIC) {
-						pic = univ.scenario.ter_types[what_ter].picture;
-						drawLargeIcon = true;
-					}
-					if(pic >= 1000) {
-						if(spec_scen_g) {
-							//print_nums(0,99,pic);
-							sf::Texture* src_gw;
-							if(drawLargeIcon) {
-								pic = pic % 1000;
-								graf_pos_ref(src_gw, custom_from) = spec_scen_g.find_graphic(pic);
-								rect_draw_some_item(*src_gw,custom_from,map_gworld,draw_rect);
-							} else {
-								graf_pos_ref(src_gw, custom_from) = spec_scen_g.find_graphic(pic % 1000);
-								custom_from.right = custom_from.left + 12;
-								custom_from.bottom = custom_from.top + 12;
-								pic /= 1000; pic--;
-								custom_from.offset((pic / 3) * 12, (pic % 3) * 12);
-								rect_draw_some_item(*src_gw, custom_from, map_gworld, draw_rect);
-							}
-						}
-					} else if(drawLargeIcon) {
-						if(pic >= 960) {
-							custom_from = calc_rect(4 * ((pic - 960) / 5),(pic - 960) % 5);
-							rect_draw_some_item(*ResMgr::get<ImageRsrc>("teranim"), custom_from, map_gworld, draw_rect);
-						} else {
-							int which_sheet = pic / 50;
-							sf::Texture* src_gw = ResMgr::get<ImageRsrc>("ter" + std::to_string(1 + which_sheet)).get();
-							pic %= 50;
-							custom_from = calc_rect(pic % 10, pic / 10);
-							rect_draw_some_item(*src_gw, custom_from, map_gworld, draw_rect);
-						}
-					} else {
-						if(univ.scenario.ter_types[what_ter].picture < 960)
-							ter_temp_from.offset(12 * (univ.scenario.ter_types[what_ter].picture % 20),
-												 12 * (univ.scenario.ter_types[what_ter].picture / 20));
-						else ter_temp_from.offset(12 * 20,
-												  12 * (univ.scenario.ter_types[what_ter].picture - 960));
-						rect_draw_some_item(small_ter_gworld,ter_temp_from,map_gworld,draw_rect);
-					}
-					
-					if(is_out() ? univ.out->roads[where.x][where.y] : univ.town.is_road(where.x,where.y)) {
-						draw_rect.inset(1,1);
-						rect_draw_some_item(*ResMgr::get<ImageRsrc>("trim"),{8,112,12,116},map_gworld,draw_rect);
-					}
-				}
-			}
-		
-		map_gworld.display();
+	else if(need_refresh && overall_mode != MODE_SHOPPING && overall_mode != MODE_TALKING) {
+		// If shopping or talking, just don't touch anything.
+		update_map_gworld(is_out());
 	}
 	
 	mini_map.setActive();
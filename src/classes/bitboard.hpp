@@ -0,0 +1,113 @@
+/*
+ *  bitboard.hpp
+ *  BoE
+ *
+ *  A 64x64 grid of bits, used to store town fields one plane per field type.
+ *
+ */
+
+#ifndef BOE_DATA_BITBOARD_H
+#define BOE_DATA_BITBOARD_H
+
+#include <cstdint>
+#include <algorithm>
+
+// Each column x is one word, with bit y set if cell (x,y) is set.
+// Thus vertical neighbours are one shift apart, and horizontal neighbours are one word apart,
+// so whole-board operations (spreading, masking, clearing a region) are a few word operations per column.
+class cBitboard {
+public:
+	static const int SIZE = 64;
+	static uint64_t bit(int y) {
+		return uint64_t(1) << y;
+	}
+	// Index of the lowest set bit in a nonzero word (de Bruijn multiplication; portable and branch-free)
+	static int lowest_bit(uint64_t w) {
+		static const int index[64] = {
+			0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+			62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+			63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+			46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6,
+		};
+		return index[((w & (~w + 1)) * uint64_t(0x03f79d71b4cb0a89)) >> 58];
+	}
+	// Mask of the cells (left..right, top..bottom), inclusive, clipped to the board.
+	static cBitboard rect(int left, int top, int right, int bottom) {
+		cBitboard r;
+		left = std::max(left, 0); top = std::max(top, 0);
+		right = std::min(right, SIZE - 1); bottom = std::min(bottom, SIZE - 1);
+		if(left > right || top > bottom) return r;
+		uint64_t rows = (bottom == SIZE - 1 ? ~uint64_t(0) : bit(bottom + 1) - 1) & ~(bit(top) - 1);
+		for(int x = left; x <= right; x++)
+			r.col[x] = rows;
+		return r;
+	}
+
+	uint64_t col[SIZE];
+
+	cBitboard() {
+		clear();
+	}
+	void clear() {
+		std::fill(col, col + SIZE, 0);
+	}
+	bool test(int x, int y) const {
+		return col[x] & bit(y);
+	}
+	void set(int x, int y, bool b = true) {
+		if(b) col[x] |= bit(y);
+		else col[x] &= ~bit(y);
+	}
+	bool any() const {
+		for(int x = 0; x < SIZE; x++)
+			if(col[x]) return true;
+		return false;
+	}
+	// The board with every set cell also spreading to its four orthogonal neighbours.
+	cBitboard grown() const {
+		cBitboard r;
+		for(int x = 0; x < SIZE; x++) {
+			uint64_t w = col[x] | col[x] << 1 | col[x] >> 1;
+			if(x > 0) w |= col[x - 1];
+			if(x < SIZE - 1) w |= col[x + 1];
+			r.col[x] = w;
+		}
+		return r;
+	}
+	// Calls f(x,y) for each set cell, in the same order as a nested x then y loop.
+	template<typename Func> void for_each(Func f) const {
+		for(int x = 0; x < SIZE; x++)
+			for(uint64_t w = col[x]; w; w &= w - 1)
+				f(x, lowest_bit(w));
+	}
+	cBitboard& operator&=(const cBitboard& other) {
+		for(int x = 0; x < SIZE; x++)
+			col[x] &= other.col[x];
+		return *this;
+	}
+	cBitboard& operator|=(const cBitboard& other) {
+		for(int x = 0; x < SIZE; x++)
+			col[x] |= other.col[x];
+		return *this;
+	}
+	// Clears every cell that is set in other
+	cBitboard& operator-=(const cBitboard& other) {
+		for(int x = 0; x < SIZE; x++)
+			col[x] &= ~other.col[x];
+		return *this;
+	}
+	cBitboard operator&(const cBitboard& other) const {
+		cBitboard r = *this;
+		return r &= other;
+	}
+	cBitboard operator|(const cBitboard& other) const {
+		cBitboard r = *this;
+		return r |= other;
+	}
+	cBitboard operator-(const cBitboard& other) const {
+		cBitboard r = *this;
+		return r -= other;
+	}
+};
+
+#endif
@@ -15,8 +15,51 @@
 
 #include "oldstructs.hpp"
 
+cActivity& cActivity::operator=(short to) {
+	value = to;
+	if(list) list->activity_changed(index, to);
+	return *this;
+}
+
+cPopulation::cPopulation(const cPopulation& other) : dudes(other.dudes), which_town(other.which_town), hostile(other.hostile) {
+	rebind();
+}
+
+cPopulation& cPopulation::operator=(const cPopulation& other) {
+	dudes = other.dudes;
+	which_town = other.which_town;
+	hostile = other.hostile;
+	rebind();
+	return *this;
+}
+
+void cPopulation::activity_changed(size_t which, short to) {
+	if(to != 0)
+		present_dudes.insert(which);
+	else present_dudes.erase(which);
+	if(to == 2)
+		awake_dudes.insert(which);
+	else awake_dudes.erase(which);
+}
+
+void cPopulation::rebind() {
+	present_dudes.clear();
+	awake_dudes.clear();
+	for(size_t i = 0; i < dudes.size(); i++) {
+		dudes[i].active.list = this;
+		dudes[i].active.index = i;
+		activity_changed(i, dudes[i].active);
+	}
+}
+
+void cPopulation::clear() {
+	dudes.clear();
+	rebind();
+}
+
 void cPopulation::append(legacy::creature_list_type old){
 	dudes.resize(60);
+	rebind();
 	for(int i = 0; i < 60; i++)
 		dudes[i].append(old.dudes[i]);
 	which_town = old.which_town;
@@ -32,7 +75,10 @@ cCreature& cPopulation::operator[](size_t n){
 }
 
 void cPopulation::init(size_t n) {
-	if(n >= dudes.size()) dudes.resize(n + 1);
+	if(n >= dudes.size()) {
+		dudes.resize(n + 1);
+		rebind();
+	}
 	dudes[n].active = 1;
 }
 
@@ -41,7 +87,10 @@ void cPopulation::init(size_t n) {
 // replaces return_monster_template() from boe.monsters.cpp
 void cPopulation::assign(size_t n, const cTownperson& other, const cMonster& base, bool easy, int difficulty_adjust){
 	// Make sure the space exists
-	if(n >= dudes.size()) dudes.resize(n + 1);
+	if(n >= dudes.size()) {
+		dudes.resize(n + 1);
+		rebind();
+	}
 	// First copy over the superclass fields
 	static_cast<cTownperson&>(dudes[n]) = other;
 	static_cast<cMonster&>(dudes[n]) = base;
@@ -68,6 +117,9 @@ void cPopulation::assign(size_t n, const cTownperson& other, const cMonster& bas
 }
 
 void cPopulation::readFrom(std::istream& in, size_t n) {
-	if(n >= dudes.size()) dudes.resize(n + 1);
+	if(n >= dudes.size()) {
+		dudes.resize(n + 1);
+		rebind();
+	}
 	dudes[n].readFrom(in);
 }
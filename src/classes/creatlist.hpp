@@ -11,6 +11,7 @@
 
 #include "monster.hpp"
 #include <iosfwd>
+#include <set>
 #include "creature.hpp"
 
 namespace legacy {
@@ -20,6 +21,12 @@ namespace legacy {
 
 class cPopulation {
 	std::vector<cCreature> dudes;
+	// Indices of the creatures that are about at all, and of the ones that are awake
+	std::set<size_t> present_dudes, awake_dudes;
+	void activity_changed(size_t which, short to);
+	// Call after dudes is replaced or resized, since the creatures may have moved.
+	void rebind();
+	friend class cActivity;
 public:
 	short which_town;
 	bool hostile;
@@ -29,12 +36,15 @@ public:
 	void assign(size_t n, const cTownperson& other, const cMonster& base, bool easy, int difficulty_adjust);
 	void readFrom(std::istream& in, size_t n);
 	size_t size() const {return dudes.size();}
-	void clear() {dudes.clear();}
+	void clear();
 	cCreature& operator[](size_t n);
 	const cCreature& operator[](size_t n) const;
+	// Kept up to date as creatures come and go, so the turn needn't look at every one.
+	const std::set<size_t>& present() const {return present_dudes;}
+	const std::set<size_t>& awake() const {return awake_dudes;}
 	cPopulation() : which_town(200) {}
-	// Apparently Visual Studio needs this to work
-	cPopulation& operator=(const cPopulation& other) = default;
+	cPopulation(const cPopulation& other);
+	cPopulation& operator=(const cPopulation& other);
 };
 
 #endif
@@ -15,10 +15,31 @@
 #include "living.hpp"
 #include "simpletypes.hpp"
 
+class cPopulation;
+
+// Whether a creature is about: 0 if not, 1 if it hasn't noticed the party yet, 2 if it's awake.
+// It reads like a short, but the population holding the creature hears of every change,
+// so that it can keep track of which ones are about without looking through all of them.
+class cActivity {
+	short value = 0;
+	cPopulation* list = nullptr;
+	size_t index = 0;
+	friend class cPopulation;
+public:
+	cActivity() = default;
+	// A copy belongs to no population until one takes it in.
+	cActivity(const cActivity& other) : value(other.value) {}
+	cActivity& operator=(const cActivity& other) {return *this = other.value;}
+	cActivity& operator=(short to);
+	cActivity& operator+=(short by) {return *this = short(value + by);}
+	cActivity& operator-=(short by) {return *this = short(value - by);}
+	operator short() const {return value;}
+};
+
 class cCreature : public cMonster, public cTownperson, public iLiving {
 public:
 	static const short charm_odds[21];
-	short active;
+	cActivity active;
 	eAttitude attitude;
 	location cur_loc;
 	short summon_time;
@@ -13,12 +13,12 @@
 #include <string>
 
 #include "location.hpp"
+#include "enum_map.hpp"
 #include "simpletypes.hpp"
 
 class iLiving {
 public:
-	// HACK: This is only really marked mutable so that I can use operator[] from const methods
-	mutable std::map<eStatus,short> status;
+	enum_map<eStatus, short, int(eStatus::CHARM) + 1> status;
 	short ap = 0;
 	eDirection direction = DIR_HERE;
 	short marked_damage = 0; // for use during animations
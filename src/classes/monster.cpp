@@ -136,6 +136,7 @@ void cMonster::append(legacy::monster_record_type& old){
 	picture_num = old.picture_num;
 	if(picture_num == 122) picture_num = 119;
 	see_spec = -1;
+	planTurn();
 }
 
 int cMonster::addAttack(unsigned short dice, unsigned short sides, eMonstMelee type) {
@@ -149,7 +150,7 @@ int cMonster::addAttack(unsigned short dice, unsigned short sides, eMonstMelee t
 	return which;
 }
 
-std::map<eMonstAbil,uAbility>::iterator cMonster::addAbil(eMonstAbilTemplate what, int param) {
+cMonstAbilities::iterator cMonster::addAbil(eMonstAbilTemplate what, int param) {
 	switch(what) {
 		// Missiles: {true, type, missile pic, dice, sides, skill, range, odds}
 		case eMonstAbilTemplate::THROWS_DARTS:
@@ -391,13 +392,79 @@ std::map<eMonstAbil,uAbility>::iterator cMonster::addAbil(eMonstAbilTemplate wha
 	return abil.end();
 }
 
+uAbility& cMonstAbilities::operator[](eMonstAbil key) {
+	if(present & bit(key))
+		return data[slot[int(key)]].second;
+	// Insert it in order, shifting up anything with a later key
+	int pos = count;
+	while(pos > 0 && data[pos - 1].first > key) {
+		data[pos] = data[pos - 1];
+		slot[int(data[pos].first)] = pos;
+		pos--;
+	}
+	data[pos] = value_type(key, uAbility());
+	slot[int(key)] = pos;
+	present |= bit(key);
+	count++;
+	return data[pos].second;
+}
+
+const uAbility& cMonstAbilities::operator[](eMonstAbil key) const {
+	static const uAbility none = uAbility();
+	if(present & bit(key))
+		return data[slot[int(key)]].second;
+	return none;
+}
+
+cMonstAbilities::iterator cMonstAbilities::erase(iterator which) {
+	present &= ~bit(which->first);
+	count--;
+	for(iterator next = which; next != end(); next++) {
+		*next = *(next + 1);
+		slot[int(next->first)] = next - data;
+	}
+	return which;
+}
+
+void cMonster::planTurn() {
+	turn_plan = 0;
+	for(auto& p : abil) {
+		if(!p.second.active) continue;
+		switch(getMonstAbilCategory(p.first)) {
+			case eMonstAbilCat::MISSILE:
+				turn_plan |= PLAN_ARCHER | PLAN_RANGED;
+				break;
+			case eMonstAbilCat::GENERAL:
+				if(p.second.gen.type == eMonstGen::TOUCH)
+					turn_plan |= PLAN_TOUCH;
+				else turn_plan |= PLAN_RANGED;
+				if(p.first == eMonstAbil::DAMAGE2 && p.second.gen.type == eMonstGen::BREATH)
+					turn_plan |= PLAN_BREATH;
+				break;
+			case eMonstAbilCat::RADIATE:
+				turn_plan |= PLAN_RADIATE;
+				break;
+			case eMonstAbilCat::SUMMON:
+				turn_plan |= PLAN_SUMMON;
+				break;
+			case eMonstAbilCat::SPECIAL:
+				if(p.first == eMonstAbil::MISSILE_WEB || p.first == eMonstAbil::RAY_HEAT)
+					turn_plan |= PLAN_RANGED;
+				else if(p.first == eMonstAbil::SPECIAL)
+					turn_plan |= PLAN_SPECIAL;
+				break;
+			case eMonstAbilCat::INVALID:
+				break;
+		}
+	}
+}
+
 cMonster::cMonster(){
-	for(int i = 0; i <= 8; i++) {
+	// This includes MARKED, just in case something weird happens
+	for(int i = 0; i <= int(eDamageType::MARKED); i++) {
 		eDamageType dmg = eDamageType(i);
 		resist[dmg] = 100;
 	}
-	// And just in case something weird happens:
-	resist[eDamageType::MARKED] = 100;
 	amorphous = mindless = invuln = guard = invisible = false;
 	level = m_health = armor = skill = 0;
 	speed = 4;
@@ -88,6 +88,52 @@ union uAbility {
 	int get_ap_cost(eMonstAbil key) const;
 };
 
+// A monster's abilities, kept sorted by key in a small inline array.
+// It has the same interface as the std::map it replaces, but a lookup is a bit test and an index,
+// and copying a monster doesn't copy a tree.
+class cMonstAbilities {
+public:
+	typedef std::pair<eMonstAbil, uAbility> value_type;
+	typedef value_type* iterator;
+	typedef const value_type* const_iterator;
+	static const int MAX = int(eMonstAbil::SUMMON) + 1;
+private:
+	value_type data[MAX];
+	signed char slot[MAX] = {}; // Where each key is in data, if it's present
+	int count = 0;
+	unsigned long present = 0;
+	static unsigned long bit(eMonstAbil key) {return 1ul << int(key);}
+public:
+	// Accessing a missing ability adds an inactive one, just like a map.
+	uAbility& operator[](eMonstAbil key);
+	// But reading a missing ability from a const table doesn't.
+	const uAbility& operator[](eMonstAbil key) const;
+	bool has(eMonstAbil key) const {return (present & bit(key)) && data[slot[int(key)]].second.active;}
+	iterator find(eMonstAbil key) {return (present & bit(key)) ? data + slot[int(key)] : end();}
+	const_iterator find(eMonstAbil key) const {return (present & bit(key)) ? data + slot[int(key)] : end();}
+	iterator erase(iterator which);
+	void clear() {count = 0; present = 0;}
+	size_t size() const {return count;}
+	bool empty() const {return count == 0;}
+	iterator begin() {return data;}
+	iterator end() {return data + count;}
+	const_iterator begin() const {return data;}
+	const_iterator end() const {return data + count;}
+};
+
+// Which parts of a monster's turn can do anything at all, given its abilities.
+// Computed once per monster type, so a turn can skip straight past the abilities it doesn't have.
+enum {
+	PLAN_ARCHER = 1, // Standard missile attack
+	PLAN_BREATH = 2, // Breath weapon
+	PLAN_RANGED = 4, // Other ranged abilities (rays, gazes, spit, webs)
+	PLAN_TOUCH = 8, // Touch abilities, used when attacking in melee
+	PLAN_SPECIAL = 16, // Calls a special node
+	PLAN_RADIATE = 32,
+	PLAN_SUMMON = 64,
+	PLAN_ALL = 127,
+};
+
 class cMonster {
 public:
 	struct cAttack{
@@ -105,11 +151,12 @@ public:
 	unsigned int mu;
 	unsigned int cl;
 	unsigned int treasure;
-	// HACK: This is only really marked mutable so that I can use operator[] from const methods
-	mutable std::map<eMonstAbil, uAbility> abil;
+	cMonstAbilities abil;
+	// Bitmask of PLAN_ values; rebuilt by planTurn() whenever the abilities change.
+	unsigned int turn_plan = PLAN_ALL;
 	item_num_t corpse_item;
 	short corpse_item_chance;
-	std::map<eDamageType, int> resist;
+	enum_map<eDamageType, int, int(eDamageType::MARKED) + 1> resist;
 	bool mindless, invuln, invisible, guard, amorphous;
 	unsigned int x_width,y_width;
 	eAttitude default_attitude;
@@ -119,7 +166,8 @@ public:
 	snd_num_t ambient_sound; // has a chance of being played every move
 	spec_num_t see_spec;
 	
-	std::map<eMonstAbil,uAbility>::iterator addAbil(eMonstAbilTemplate what, int param = 0);
+	cMonstAbilities::iterator addAbil(eMonstAbilTemplate what, int param = 0);
+	void planTurn();
 	int addAttack(unsigned short dice, unsigned short sides, eMonstMelee type = eMonstMelee::SWING);
 	
 	void append(legacy::monster_record_type& old);
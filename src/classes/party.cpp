@@ -13,6 +13,7 @@
 #include <map>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 
 #include "scenario.hpp"
 #include "universe.hpp"
@@ -62,8 +63,9 @@ void cParty::append(legacy::party_record_type& old){
 		for(j = 0; j < 10; j++)
 			stuff_done[i][j] = old.stuff_done[i][j];
 	for(i = 0; i < 200; i++)
-		for(j = 0; j < 8; j++)
-			item_taken[i][j] = old.item_taken[i][j];
+		for(j = 0; j < 64; j++)
+			if(old.item_taken[i][j / 8] & (1 << j % 8))
+				item_taken[i].set(j);
 	light_level = old.light_level;
 	if(stuff_done[305][0] > 0)
 		status[ePartyStatus::STEALTH] = stuff_done[305][0];
@@ -90,7 +92,7 @@ void cParty::append(legacy::party_record_type& old){
 		boats[i].append(old.boats[i]);
 		horses[i].append(old.horses[i]);
 		cTimer t;
-		t.time = old.party_event_timers[i];
+		t.time = age + old.party_event_timers[i];
 		t.node_type = old.global_or_town[i];
 		t.node = old.node_to_call[i];
 		party_event_timers.push_back(t);
@@ -138,7 +140,8 @@ void cParty::append(legacy::party_record_type& old){
 		alchemy[i] = old.alchemy[i];
 	for(i = 0; i < 200; i++){
 		can_find_town[i] = old.can_find_town[i];
-		m_killed[i] = old.m_killed[i];
+		if(old.m_killed[i] > 0)
+			m_killed[i] = old.m_killed[i];
 	}
 	for(i = 0; i < 100; i++)
 		key_times[i] = old.key_times[i];
@@ -534,13 +537,19 @@ bool cParty::check_class(unsigned int item_class,bool take) {
 bool cParty::start_timer(short time, short node, short type){
 	if(party_event_timers.size() == party_event_timers.max_size()) return false; // Shouldn't be reached
 	cTimer t;
-	t.time = time;
+	t.time = age + time;
 	t.node_type = type;
 	t.node = node;
 	party_event_timers.push_back(t);
 	return(true);
 }
 
+void cParty::shift_age(long by) {
+	age += by;
+	for(cTimer& timer : party_event_timers)
+		timer.time += by;
+}
+
 void cParty::writeTo(std::ostream& file) const {
 	file << "CREATEVERSION " << std::hex << OBOE_CURRENT_VERSION << std::dec << '\n';
 	file << "AGE " << age << '\n';
@@ -558,12 +567,11 @@ void cParty::writeTo(std::ostream& file) const {
 		file << "POINTER " << iter->first << ' ' << iter->second.first << ' ' << iter->second.second << '\n';
 	for(int i = 0; i < magic_ptrs.size(); i++)
 		file << "POINTER " << i << ' ' << int(magic_ptrs[i]) << '\n';
-	for(int i = 0; i < 200; i++)
-		if(item_taken[i][0] > 0 || item_taken[i][1] > 0 || item_taken[i][2] > 0 || item_taken[i][3] > 0 ||
-		   item_taken[i][4] > 0 || item_taken[i][5] > 0 || item_taken[i][6] > 0 || item_taken[i][7] > 0) {
-			file << "ITEMTAKEN " << i;
+	for(auto& kv : item_taken)
+		if(kv.second.any()) {
+			file << "ITEMTAKEN " << kv.first;
 			for(int j = 0; j < 8; j++)
-				file << ' ' << unsigned(item_taken[i][j]);
+				file << ' ' << ((kv.second >> 8 * j) & std::bitset<64>(0xff)).to_ulong();
 			file << '\n';
 		}
 	file << "LIGHT " << light_level << '\n';
@@ -597,16 +605,16 @@ void cParty::writeTo(std::ostream& file) const {
 	for(int i = 0; i < 20; i++)
 		if(alchemy[i])
 			file << "ALCHEMY " << i << '\n';
-	for(int i = 0; i < 200; i++)
-		if(can_find_town[i])
-			file << "TOWNVISIBLE " << i << '\n';
+	for(auto& kv : can_find_town)
+		if(kv.second)
+			file << "TOWNVISIBLE " << kv.first << '\n';
 	for(auto key : key_times)
 		file << "EVENT " << key.first << ' ' << key.second << '\n';
 	for(int i : spec_items)
 		file << "ITEM " << i << '\n';
-	for(int i = 0; i < 200; i++)
-		if(m_killed[i] > 0)
-			file << "TOWNSLAUGHTER " << i << ' ' << m_killed[i] << '\n';
+	for(auto& kv : m_killed)
+		if(kv.second > 0)
+			file << "TOWNSLAUGHTER " << kv.first << ' ' << kv.second << '\n';
 	file << "KILLS " << total_m_killed << '\n';
 	file << "DAMAGE " << total_dam_done << '\n';
 	file << "WOUNDS " << total_dam_taken << '\n';
@@ -676,8 +684,9 @@ void cParty::writeTo(std::ostream& file) const {
 		}
 	file << '\f';
 	file << '\f';
+	// Saved as the time left, as they always were
 	for(unsigned int i = 0; i < party_event_timers.size(); i++)
-		file << "TIMER " << ' ' << party_event_timers[i].time << ' ' << party_event_timers[i].node_type
+		file << "TIMER " << i << ' ' << std::max(0L, party_event_timers[i].time - long(age)) << ' ' << party_event_timers[i].node_type
 			 << ' ' << party_event_timers[i].node << '\f';
 	file << '\f';
 	for(int i = 0; i < 4; i++)
@@ -790,11 +799,13 @@ void cParty::readFrom(std::istream& file){
 		}else if(cur == "ITEMTAKEN"){
 			int i;
 			sin >> i;
+			std::bitset<64> taken;
 			for(int j = 0; j < 8; j++) {
 				unsigned int n;
 				sin >> n;
-				item_taken[i][j] = n;
+				taken |= std::bitset<64>(n & 0xff) << 8 * j;
 			}
+			item_taken[i] = taken;
 		}else if(cur == "LIGHT")
 			sin >> light_level;
 		else if(cur == "OUTCORNER")
@@ -927,6 +938,7 @@ void cParty::readFrom(std::istream& file){
 			bin >> i;
 			cTimer timer;
 			bin >> timer.time >> timer.node_type >> timer.node;
+			timer.time += age; // AGE is in the first block
 			party_event_timers.push_back(timer);
 		} else if(cur == "CREATURE") {
 			int i, j;
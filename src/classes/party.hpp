@@ -14,6 +14,7 @@
 #include <array>
 #include <map>
 #include <set>
+#include <bitset>
 #include "vehicle.hpp"
 #include "creatlist.hpp"
 #include "item.hpp"
@@ -77,7 +78,7 @@ public:
 	bool easy_mode = false, less_wm = false;
 	// End former magic SDFs
 	std::array<unsigned char,90> magic_ptrs;
-	unsigned char item_taken[200][8];
+	std::map<int,std::bitset<64>> item_taken; // which of each town's preset items have been taken
 	short light_level;
 	location outdoor_corner;
 	location i_w_c;
@@ -109,11 +110,11 @@ public:
 	eDirection direction;
 	short at_which_save_slot;
 	bool alchemy[20];
-	bool can_find_town[200];
+	std::map<int,bool> can_find_town;
 	std::map<int,int> key_times;
-	std::vector<cTimer> party_event_timers;
+	std::vector<cTimer> party_event_timers; // The time of each is the age at which it goes off
 	std::set<int> spec_items;
-	long m_killed[200]; // monsters killed per town
+	std::map<int,long> m_killed; // monsters killed per town
 	long long total_m_killed, total_dam_done, total_xp_gained, total_dam_taken;
 	std::string scen_name;
 private:
@@ -181,6 +182,8 @@ public:
 	bool add_to_journal(const std::string& event, short day);
 	bool record(eEncNoteType type, const std::string& what, const std::string& where);
 	bool start_timer(short time, short node, short type);
+	// Moves the age without passing time, so the party's timers have just as long to go.
+	void shift_age(long by);
 	cPlayer& operator[](unsigned short n);
 	const cPlayer& operator[](unsigned short n) const;
 	void writeTo(std::ostream& file) const;
@@ -464,6 +464,8 @@ bool cPlayer::give_item(cItem item, int flags) {
 		party.quest_status[item.item_level] = eQuestStatus::STARTED;
 		party.quest_start[item.item_level] = party.calc_day();
 		party.quest_source[item.item_level] = -1;
+		if(quests_changed)
+			quests_changed();
 		if(do_print && print_result)
 			print_result("You get a quest.");
 		return true;
@@ -1171,3 +1173,4 @@ void cPlayer::readFrom(std::istream& file){
 }
 
 void(* cPlayer::give_help)(short,short) = nullptr;
+void(* cPlayer::quests_changed)() = nullptr;
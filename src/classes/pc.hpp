@@ -38,10 +38,11 @@ class cPlayer : public iLiving {
 	cParty& party;
 public:
 	static void(* give_help)(short,short);
+	// Called when an item starts a quest, since that may set a deadline going
+	static void(* quests_changed)();
 	eMainStatus main_status;
 	std::string name;
-	// HACK: This is only really marked mutable so that I can use operator[] from const methods
-	mutable std::map<eSkill, short> skills;
+	enum_map<eSkill, short, int(eSkill::MAX_SP) + 1> skills;
 	unsigned short max_health;
 	short cur_health;
 	unsigned short max_sp;
@@ -55,8 +56,7 @@ public:
 	bool mage_spells[62];
 	pic_num_t which_graphic;
 	short weap_poisoned;
-	// HACK: This is only really marked mutable so that I can use operator[] from const methods
-	mutable std::map<eTrait,bool> traits;
+	enum_map<eTrait, bool, int(eTrait::ANAMA) + 1> traits;
 	eRace race;
 	long unique_id;
 	// transient stuff
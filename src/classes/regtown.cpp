@@ -367,6 +367,7 @@ unsigned char& cBigTown::lighting(size_t i, size_t r){
 }
 
 cBigTown::cBigTown(cScenario& scenario) : cTown(scenario) {
+	dim = 64;
 	for(size_t i = 0; i < max_dim(); i++)
 		for(size_t j = 0; j < max_dim(); j++) {
 			terrain(i,j) = scenario.default_ground;
@@ -376,6 +377,7 @@ cBigTown::cBigTown(cScenario& scenario) : cTown(scenario) {
 }
 
 cMedTown::cMedTown(cScenario& scenario) : cTown(scenario) {
+	dim = 48;
 	for(size_t i = 0; i < max_dim(); i++)
 		for(size_t j = 0; j < max_dim(); j++) {
 			terrain(i,j) = scenario.default_ground;
@@ -385,6 +387,7 @@ cMedTown::cMedTown(cScenario& scenario) : cTown(scenario) {
 }
 
 cTinyTown::cTinyTown(cScenario& scenario) : cTown(scenario) {
+	dim = 32;
 	for(size_t i = 0; i < max_dim(); i++)
 		for(size_t j = 0; j < max_dim(); j++) {
 			terrain(i,j) = scenario.default_ground;
@@ -393,14 +396,26 @@ cTinyTown::cTinyTown(cScenario& scenario) : cTown(scenario) {
 	init_start();
 }
 
-size_t cBigTown::max_dim() const {
-	return 64;
+ter_view_t cBigTown::terrain_view() {
+	return {&ter[0][0], 64, 64, 64};
 }
 
-size_t cMedTown::max_dim() const {
-	return 48;
+light_view_t cBigTown::lighting_view() {
+	return {&light[0][0], 8, 64, 64};
 }
 
-size_t cTinyTown::max_dim() const {
-	return 32;
+ter_view_t cMedTown::terrain_view() {
+	return {&ter[0][0], 48, 48, 48};
+}
+
+light_view_t cMedTown::lighting_view() {
+	return {&light[0][0], 6, 48, 48};
+}
+
+ter_view_t cTinyTown::terrain_view() {
+	return {&ter[0][0], 32, 32, 32};
+}
+
+light_view_t cTinyTown::lighting_view() {
+	return {&light[0][0], 4, 32, 32};
 }
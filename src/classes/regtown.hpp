@@ -29,7 +29,8 @@ public:
 	void append(legacy::big_tr_type& old, int town_num);
 	ter_num_t& terrain(size_t x, size_t y);
 	unsigned char& lighting(size_t i, size_t r);
-	size_t max_dim() const;
+	ter_view_t terrain_view();
+	light_view_t lighting_view();
 	
 	explicit cBigTown(cScenario& scenario);
 	void writeTerrainTo(std::ostream& file);
@@ -43,7 +44,8 @@ public:
 	void append(legacy::ave_tr_type& old, int town_num);
 	ter_num_t& terrain(size_t x, size_t y);
 	unsigned char& lighting(size_t i, size_t r);
-	size_t max_dim() const;
+	ter_view_t terrain_view();
+	light_view_t lighting_view();
 	
 	explicit cMedTown(cScenario& scenario);
 	void writeTerrainTo(std::ostream& file);
@@ -57,7 +59,8 @@ public:
 	void append(legacy::tiny_tr_type& old, int town_num);
 	ter_num_t& terrain(size_t x, size_t y);
 	unsigned char& lighting(size_t i, size_t r);
-	size_t max_dim() const;
+	ter_view_t terrain_view();
+	light_view_t lighting_view();
 	
 	explicit cTinyTown(cScenario& scenario);
 	void writeTerrainTo(std::ostream& file);
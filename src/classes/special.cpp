@@ -16,6 +16,7 @@
 #include "strdlog.hpp"
 #include "oldstructs.hpp"
 #include "graphtool.hpp"
+#include "party.hpp"
 
 cSpecial::cSpecial(){
 	type = eSpecType::NONE;
@@ -33,6 +34,37 @@ cSpecial::cSpecial(){
 	ex2b = -1;
 	ex2c = -1;
 	jumpto = -1;
+	ptr_slots = (1 << NUM_SLOTS) - 1;
+	category = getNodeCategory(type);
+}
+
+static short cSpecial::* const slot_fields[cSpecial::NUM_SLOTS] = {
+	&cSpecial::sd1, &cSpecial::sd2, &cSpecial::m1, &cSpecial::m2, &cSpecial::m3, &cSpecial::pic, &cSpecial::pictype,
+	&cSpecial::ex1a, &cSpecial::ex1b, &cSpecial::ex1c, &cSpecial::ex2a, &cSpecial::ex2b, &cSpecial::ex2c, &cSpecial::jumpto,
+};
+
+short& cSpecial::slot(int i) {
+	return this->*slot_fields[i];
+}
+
+short cSpecial::slot(int i) const {
+	return this->*slot_fields[i];
+}
+
+void cSpecial::compile() {
+	ptr_slots = 0;
+	for(int i = 0; i < NUM_SLOTS; i++)
+		if(slot(i) <= -10)
+			ptr_slots |= 1 << i;
+	category = getNodeCategory(type);
+}
+
+void cSpecial::resolve_pointers(cParty& party) {
+	for(int i = 0; i < NUM_SLOTS; i++) {
+		short& val = slot(i);
+		if((ptr_slots & (1 << i)) && val <= -10)
+			val = party.get_ptr(-val);
+	}
 }
 
 void cSpecial::writeTo(std::ostream& file, int n) const {
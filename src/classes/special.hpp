@@ -16,6 +16,7 @@
 #include "location.hpp"
 
 namespace legacy { struct special_node_type; };
+class cParty;
 
 class cSpecial {
 public:
@@ -34,10 +35,23 @@ public:
 	short ex2b;
 	short ex2c;
 	short jumpto;
+	// The rest is worked out by compile() and not saved.
+	// Bit i is set if slot(i) holds a pointer (-10 or less) to be looked up when the node runs.
+	// Until compile() is called, every slot is assumed to need checking.
+	unsigned short ptr_slots;
+	eSpecCat category;
+	
+	// The numeric fields, in the order sd1, sd2, m1-m3, pic, pictype, ex1a-c, ex2a-c, jumpto
+	static const int NUM_SLOTS = 14;
+	short& slot(int i);
+	short slot(int i) const;
 	
 	cSpecial();
 	void append(legacy::special_node_type& old);
 	void writeTo(std::ostream& file, int n) const;
+	void compile();
+	// Replaces the pointers in the slots marked by ptr_slots with the values they point to.
+	void resolve_pointers(cParty& party);
 };
 
 class cTimer {
@@ -185,18 +185,21 @@ bool cTown::is_cleaned_out(long m_killed) {
 }
 
 void cTown::set_up_lights() {
-	using namespace std::placeholders;
 	short rad;
 	location where,l;
 	bool where_lit[64][64] = {0};
-	auto get_obscurity = std::bind(&cTown::light_obscurity, this, _1, _2);
+	ter_view_t ter = terrain_view();
+	light_view_t light = lighting_view();
+	auto get_obscurity = [this, &ter](short x, short y) {
+		return light_obscurity(ter(x,y));
+	};
 	
 	// Find bonfires, braziers, etc.
 	for(short i = 0; i < this->max_dim(); i++)
 		for(short j = 0; j < this->max_dim(); j++) {
 			l.x = i;
 			l.y = j;
-			rad = scenario->ter_types[this->terrain(i,j)].light_radius;
+			rad = scenario->ter_types[ter(i,j)].light_radius;
 			if(rad > 0) {
 				for(where.x = std::max(0,i - rad); where.x < min(this->max_dim(),short(i + rad + 1)); where.x++)
 					for(where.y = std::max(0,j - rad); where.y < min(this->max_dim(),short(j + rad + 1)); where.y++)
@@ -204,23 +207,20 @@ void cTown::set_up_lights() {
 							where_lit[where.x][where.y] = true;
 			}
 		}
-	for(short i = 0; i < this->max_dim() / 8; i++)
-		for(short j = 0; j < this->max_dim(); j++)
-			this->lighting(i,j) = 0;
+	for(size_t i = 0; i < light.width; i++)
+		for(size_t j = 0; j < light.height; j++)
+			light(i,j) = 0;
 	for(where.x = 0; where.x < this->max_dim(); where.x++)
 		for(where.y = 0; where.y < this->max_dim(); where.y++) {
 			if(where_lit[where.x][where.y]) {
-				this->lighting(where.x / 8,where.y) = this->lighting(where.x / 8,where.y) | (1 << (where.x % 8));
+				light(where.x / 8,where.y) |= 1 << (where.x % 8);
 			}
 		}
 }
 
-short cTown::light_obscurity(short x,short y) {
-	ter_num_t what_terrain;
+short cTown::light_obscurity(ter_num_t what_terrain) {
 	eTerObstruct store;
 	
-	what_terrain = this->terrain(x,y);
-	
 	store = scenario->ter_types[what_terrain].blockage;
 	if(store == eTerObstruct::BLOCK_SIGHT || store == eTerObstruct::BLOCK_MOVE_AND_SIGHT)
 		return 5;
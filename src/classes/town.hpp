@@ -32,9 +32,20 @@ namespace legacy {
 
 class cScenario;
 
+// One of a town's grids laid out flat, so that loops over many spaces can index it
+// directly instead of making a virtual call for each one. Element i,j is data[i * stride + j].
+template<typename T> struct town_grid_t {
+	T* data;
+	size_t width, height, stride;
+	T& operator()(size_t i, size_t j) const {return data[i * stride + j];}
+};
+typedef town_grid_t<ter_num_t> ter_view_t;
+typedef town_grid_t<unsigned char> light_view_t; // i is x / 8, as for cTown::lighting
+
 class cTown { // formerly town_record_type
 protected:
 	cScenario* scenario;
+	size_t dim = 0; // Set by each size of town
 public:
 	class cWandering { // formerly wandering_type
 	public:
@@ -99,11 +110,13 @@ public:
 	virtual void append(legacy::tiny_tr_type& old, int town_num);
 	virtual ter_num_t& terrain(size_t x, size_t y) = 0;
 	virtual unsigned char& lighting(size_t i, size_t r) = 0;
-	virtual size_t max_dim() const = 0;
+	virtual ter_view_t terrain_view() = 0;
+	virtual light_view_t lighting_view() = 0;
+	size_t max_dim() const {return dim;}
 	virtual bool is_templated() const {return false;}
 	void init_start();
 	void set_up_lights();
-	short light_obscurity(short x,short y); // Obscurity function used for calculating lighting
+	short light_obscurity(ter_num_t what_terrain); // Obscurity function used for calculating lighting
 	bool is_cleaned_out(long m_killed);
 	
 	explicit cTown(cScenario& scenario);
@@ -13,10 +13,12 @@
 #include <map>
 #include <sstream>
 #include <stack>
+#include <algorithm>
 
 #include "regtown.hpp"
 #include "oldstructs.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "fileio.hpp"
 
 void cCurOut::append(legacy::out_info_type& old){
@@ -31,7 +33,7 @@ void cCurTown::append(legacy::current_town_type& old){
 	record()->append(old.town);
 	for(int i = 0; i < 64; i++)
 		for(int j = 0; j < 64; j++)
-			fields[i][j] = old.explored[i][j];
+			set_fields(i, j, old.explored[i][j]);
 	monst.append(old.monst);
 	in_boat = old.in_boat;
 	p_loc.x = old.p_loc.x;
@@ -66,18 +68,42 @@ void cCurTown::append(legacy::town_item_list& old){
 
 void cUniverse::append(legacy::stored_town_maps_type& old){
 	for(int n = 0; n < 200; n++)
-		for(int i = 0; i < 8; i++)
-			for(int j = 0; j < 64; j++)
-				town_maps[n][i][j] = old.town_maps[n][i][j];
+		town_maps.append(n, old.town_maps[n]);
 }
 
 void cUniverse::append(legacy::stored_outdoor_maps_type& old){
 	for(int n = 0; n < 100; n++)
-		for(int i = 0; i < 6; i++)
-			for(int j = 0; j < 48; j++)
-				out_maps[n][i][j] = old.outdoor_maps[n][i][j];
+		out_maps.append(n, old.outdoor_maps[n]);
+}
+
+template<int dim> void cExploredMaps<dim>::readLegacy(std::istream& file, size_t count) {
+	unsigned char old[dim / 8][dim];
+	for(size_t n = 0; n < count; n++) {
+		if(!file.read(reinterpret_cast<char*>(old), sizeof(old)))
+			break;
+		append(n, old);
+	}
+}
+
+// One line per explored map: its number, then its bits as 0s and 1s
+template<int dim> void cExploredMaps<dim>::writeTo(std::ostream& file) const {
+	for(auto& kv : maps)
+		if(kv.second.any())
+			file << kv.first << ' ' << kv.second << '\n';
+}
+
+template<int dim> void cExploredMaps<dim>::readFrom(std::istream& file) {
+	maps.clear();
+	size_t which;
+	std::bitset<dim * dim> bits;
+	while(file >> which >> bits)
+		if(bits.any())
+			maps[which] = bits;
 }
 
+template class cExploredMaps<64>;
+template class cExploredMaps<48>;
+
 void cCurTown::append(unsigned char(& old_sfx)[64][64], unsigned char(& old_misc_i)[64][64]){
 	for(int i = 0; i < 64; i++)
 		for(int j = 0; j < 64; j++){
@@ -86,8 +112,8 @@ void cCurTown::append(unsigned char(& old_sfx)[64][64], unsigned char(& old_misc
 			tmp_misc_i = old_misc_i[i][j];
 			tmp_sfx <<= 16;
 			tmp_misc_i <<= 8;
-			fields[i][j] = tmp_sfx;
-			fields[i][j] = tmp_misc_i;
+			set_fields(i, j, tmp_sfx);
+			set_fields(i, j, tmp_misc_i);
 		}
 }
 
@@ -97,10 +123,7 @@ cTown* cCurTown::operator -> (){
 
 void cCurTown::place_preset_fields() {
 	// Initialize barriers, etc. Note non-sfx gets forgotten if this is a town recently visited.
-	for(int i = 0; i < 64; i++)
-		for(int j = 0; j < 64; j++) {
-			fields[i][j] = 0;
-		}
+	clear_fields();
 	for(size_t i = 0; i < record()->preset_fields.size(); i++) {
 		switch(record()->preset_fields[i].type){
 			case OBJECT_BLOCK:
@@ -192,55 +215,55 @@ cTown*const cCurTown::record() const {
 
 bool cCurTown::is_explored(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SPECIAL_EXPLORED;
+	return fields[SPECIAL_EXPLORED].test(x,y);
 }
 
 bool cCurTown::is_force_wall(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & WALL_FORCE;
+	return fields[WALL_FORCE].test(x,y);
 }
 
 bool cCurTown::is_fire_wall(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & WALL_FIRE;
+	return fields[WALL_FIRE].test(x,y);
 }
 
 bool cCurTown::is_antimagic(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & FIELD_ANTIMAGIC;
+	return fields[FIELD_ANTIMAGIC].test(x,y);
 }
 
 bool cCurTown::is_scloud(short x, short y) const{ // stinking cloud
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & CLOUD_STINK;
+	return fields[CLOUD_STINK].test(x,y);
 }
 
 bool cCurTown::is_ice_wall(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & WALL_ICE;
+	return fields[WALL_ICE].test(x,y);
 }
 
 bool cCurTown::is_blade_wall(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & WALL_BLADES;
+	return fields[WALL_BLADES].test(x,y);
 }
 
 bool cCurTown::is_sleep_cloud(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & CLOUD_SLEEP;
+	return fields[CLOUD_SLEEP].test(x,y);
 }
 
 bool cCurTown::is_block(short x, short y) const{ // currently unused
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & OBJECT_BLOCK;
+	return fields[OBJECT_BLOCK].test(x,y);
 }
 
 bool cCurTown::is_spot(short x, short y) const{
-	return fields[x][y] & SPECIAL_SPOT;
+	return fields[SPECIAL_SPOT].test(x,y);
 }
 
 bool cCurTown::is_road(short x, short y) const{
-	return fields[x][y] & SPECIAL_ROAD;
+	return fields[SPECIAL_ROAD].test(x,y);
 }
 
 bool cCurTown::is_special(short x, short y) const{
@@ -254,342 +277,356 @@ bool cCurTown::is_special(short x, short y) const{
 
 bool cCurTown::is_web(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & FIELD_WEB;
+	return fields[FIELD_WEB].test(x,y);
 }
 
 bool cCurTown::is_crate(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & OBJECT_CRATE;
+	return fields[OBJECT_CRATE].test(x,y);
 }
 
 bool cCurTown::is_barrel(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & OBJECT_BARREL;
+	return fields[OBJECT_BARREL].test(x,y);
 }
 
 bool cCurTown::is_fire_barr(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & BARRIER_FIRE;
+	return fields[BARRIER_FIRE].test(x,y);
 }
 
 bool cCurTown::is_force_barr(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & BARRIER_FORCE;
+	return fields[BARRIER_FORCE].test(x,y);
 }
 
 bool cCurTown::is_quickfire(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & FIELD_QUICKFIRE;
+	return fields[FIELD_QUICKFIRE].test(x,y);
 }
 
 bool cCurTown::is_sm_blood(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_SMALL_BLOOD;
+	return fields[SFX_SMALL_BLOOD].test(x,y);
 }
 
 bool cCurTown::is_med_blood(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_MEDIUM_BLOOD;
+	return fields[SFX_MEDIUM_BLOOD].test(x,y);
 }
 
 bool cCurTown::is_lg_blood(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_LARGE_BLOOD;
+	return fields[SFX_LARGE_BLOOD].test(x,y);
 }
 
 bool cCurTown::is_sm_slime(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_SMALL_SLIME;
+	return fields[SFX_SMALL_SLIME].test(x,y);
 }
 
 bool cCurTown::is_lg_slime(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_LARGE_SLIME;
+	return fields[SFX_LARGE_SLIME].test(x,y);
 }
 
 bool cCurTown::is_ash(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_ASH;
+	return fields[SFX_ASH].test(x,y);
 }
 
 bool cCurTown::is_bones(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_BONES;
+	return fields[SFX_BONES].test(x,y);
 }
 
 bool cCurTown::is_rubble(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & SFX_RUBBLE;
+	return fields[SFX_RUBBLE].test(x,y);
 }
 
 bool cCurTown::is_force_cage(short x, short y) const{
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	return fields[x][y] & BARRIER_CAGE;
+	return fields[BARRIER_CAGE].test(x,y);
+}
+
+// What a field needs from the terrain under it.
+enum class eFieldGround {ANY, PASSABLE, SEE_THROUGH, CLEAR};
+
+// The placement rules for each field type.
+// blocked_by - fields that prevent this one from being placed
+// displaces - fields that this one removes when placed
+// antimagic_odds - if nonzero, placing this on antimagic only succeeds one time in this many
+struct field_rule_t {
+	eFieldGround ground;
+	unsigned long blocked_by, displaces;
+	short antimagic_odds;
+};
+
+static field_rule_t get_field_rule(eFieldType type) {
+	static const unsigned long all_sfx = SFX_SMALL_BLOOD | SFX_MEDIUM_BLOOD | SFX_LARGE_BLOOD | SFX_SMALL_SLIME | SFX_LARGE_SLIME | SFX_ASH | SFX_BONES | SFX_RUBBLE;
+	static const unsigned long barriers = BARRIER_FIRE | BARRIER_FORCE;
+	static const unsigned long magic_fields = WALL_FORCE | WALL_FIRE | FIELD_ANTIMAGIC | CLOUD_STINK | WALL_ICE | WALL_BLADES | CLOUD_SLEEP;
+	field_rule_t rule = {eFieldGround::ANY, 0, 0, 0};
+	switch(type) {
+		case WALL_FORCE:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = FIELD_ANTIMAGIC | WALL_BLADES | FIELD_QUICKFIRE | OBJECT_CRATE | OBJECT_BARREL | barriers;
+			rule.displaces = FIELD_WEB | WALL_FIRE;
+			break;
+		case WALL_FIRE:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = FIELD_ANTIMAGIC | WALL_BLADES | FIELD_QUICKFIRE | WALL_ICE | OBJECT_CRATE | OBJECT_BARREL | barriers;
+			rule.blocked_by |= FIELD_WEB | CLOUD_STINK | CLOUD_SLEEP;
+			rule.displaces = FIELD_WEB;
+			break;
+		case FIELD_ANTIMAGIC:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = FIELD_QUICKFIRE | WALL_FORCE | WALL_FIRE;
+			rule.displaces = magic_fields;
+			break;
+		case CLOUD_STINK:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = WALL_FORCE | WALL_FIRE | WALL_ICE | WALL_BLADES | FIELD_ANTIMAGIC | CLOUD_SLEEP | FIELD_QUICKFIRE | barriers;
+			break;
+		case WALL_ICE:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = WALL_FORCE | WALL_BLADES | FIELD_ANTIMAGIC | FIELD_WEB | OBJECT_CRATE | OBJECT_BARREL | FIELD_QUICKFIRE | barriers;
+			rule.displaces = WALL_FIRE | CLOUD_STINK;
+			break;
+		case WALL_BLADES: case CLOUD_SLEEP:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = FIELD_QUICKFIRE | FIELD_ANTIMAGIC | barriers;
+			rule.displaces = WALL_FORCE | WALL_FIRE;
+			break;
+		case FIELD_WEB:
+			rule.ground = eFieldGround::PASSABLE;
+			rule.blocked_by = FIELD_QUICKFIRE | WALL_FORCE | WALL_FIRE | FIELD_ANTIMAGIC | WALL_ICE | WALL_BLADES | CLOUD_SLEEP | barriers;
+			break;
+		case OBJECT_CRATE:
+			rule.blocked_by = FIELD_QUICKFIRE | OBJECT_BARREL | barriers;
+			break;
+		case OBJECT_BARREL:
+			rule.blocked_by = FIELD_QUICKFIRE | OBJECT_CRATE | barriers;
+			break;
+		case BARRIER_FIRE: case BARRIER_FORCE:
+			rule.blocked_by = FIELD_QUICKFIRE | OBJECT_CRATE | OBJECT_BARREL | (barriers & ~type);
+			rule.displaces = FIELD_WEB | magic_fields;
+			rule.antimagic_odds = type == BARRIER_FIRE ? 4 : 3;
+			break;
+		case FIELD_QUICKFIRE:
+			// TODO: Isn't it a little odd that BLOCK_MOVE_AND_SHOOT isn't included here?
+			rule.ground = eFieldGround::SEE_THROUGH;
+			rule.blocked_by = barriers;
+			rule.displaces = FIELD_WEB | OBJECT_CRATE | OBJECT_BARREL | magic_fields | barriers;
+			rule.antimagic_odds = 2;
+			break;
+		case SFX_SMALL_BLOOD:
+			rule.blocked_by = SFX_MEDIUM_BLOOD | SFX_LARGE_BLOOD;
+			rule.displaces = all_sfx & ~(SFX_SMALL_BLOOD | rule.blocked_by);
+			rule.ground = eFieldGround::CLEAR;
+			break;
+		case SFX_MEDIUM_BLOOD:
+			rule.blocked_by = SFX_LARGE_BLOOD;
+			rule.displaces = all_sfx & ~(SFX_MEDIUM_BLOOD | rule.blocked_by);
+			rule.ground = eFieldGround::CLEAR;
+			break;
+		case SFX_SMALL_SLIME:
+			rule.blocked_by = SFX_LARGE_SLIME;
+			rule.displaces = all_sfx & ~(SFX_SMALL_SLIME | rule.blocked_by);
+			rule.ground = eFieldGround::CLEAR;
+			break;
+		case SFX_LARGE_BLOOD: case SFX_LARGE_SLIME: case SFX_ASH: case SFX_BONES: case SFX_RUBBLE:
+			rule.displaces = all_sfx & ~type;
+			rule.ground = eFieldGround::CLEAR;
+			break;
+			// TODO: Consider whether placing a forcecage should erase anything already present, or fail due to something already present
+			// TODO: Also consider checking for forcecage in some of the other placement functions.
+		case BARRIER_CAGE:
+			// These are simple flags that can always be placed.
+		case SPECIAL_EXPLORED: case OBJECT_BLOCK: case SPECIAL_SPOT: case SPECIAL_ROAD:
+			break;
+			// These don't index anything.
+		case FIELD_DISPEL: case FIELD_SMASH:
+			break;
+	}
+	return rule;
 }
 
-bool cCurTown::set_explored(short x, short y, bool b){
+bool cCurTown::ground_allows(eFieldType type, short x, short y) {
+	eFieldGround ground = get_field_rule(type).ground;
+	if(ground == eFieldGround::ANY)
+		return true;
+	if(ground == eFieldGround::PASSABLE)
+		return !is_impassable(x,y);
+	if(ground == eFieldGround::CLEAR)
+		return free_for_sfx(x,y);
+	ter_num_t ter = record()->terrain(x,y);
+	eTerObstruct blockage = univ.scenario.ter_types[ter].blockage;
+	return blockage != eTerObstruct::BLOCK_SIGHT && blockage != eTerObstruct::BLOCK_MOVE_AND_SIGHT;
+}
+
+unsigned long cCurTown::get_fields(short x, short y) const {
+	unsigned long mask = 0;
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		if(fields[f].test(x,y))
+			mask |= eFieldType(f);
+	return mask;
+}
+
+void cCurTown::set_fields(short x, short y, unsigned long mask) {
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		fields[f].set(x, y, mask & eFieldType(f));
+}
+
+void cCurTown::clear_fields() {
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		fields[f].clear();
+}
+
+cBitboard cCurTown::town_area() const {
+	return cBitboard::rect(0, 0, record()->max_dim(), record()->max_dim());
+}
+
+bool cCurTown::place_field(eFieldType type, short x, short y) {
+	if(type > SPECIAL_ROAD) return false;
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b) fields[x][y] |=  SPECIAL_EXPLORED;
-	else  fields[x][y] &= ~SPECIAL_EXPLORED;
+	field_rule_t rule = get_field_rule(type);
+	if(!ground_allows(type, x, y))
+		return false;
+	if(get_fields(x,y) & rule.blocked_by)
+		return false;
+	if(rule.antimagic_odds > 0 && is_antimagic(x,y) && get_ran(1,1,rule.antimagic_odds) > 1)
+		return false;
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		if(rule.displaces & eFieldType(f))
+			fields[f].set(x, y, false);
+	if(type == FIELD_QUICKFIRE)
+		quickfire_present = true;
+	fields[type].set(x,y);
 	return true;
 }
 
-bool cCurTown::set_force_wall(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, there's no room for field.
-		if(is_impassable(x,y))
-			return false;
-		if(is_antimagic(x,y) || is_blade_wall(x,y) || is_quickfire(x,y))
-			return false;
-		if(is_crate(x,y) || is_barrel(x,y) || is_fire_barr(x,y) || is_force_barr(x,y))
-			return false;
-		set_web(x,y,false);
-		set_fire_wall(x,y,false);
-		fields[x][y]  |=  WALL_FORCE;
+cBitboard cCurTown::place_fields(eFieldType type, cBitboard where) {
+	if(type > SPECIAL_ROAD) return cBitboard();
+	field_rule_t rule = get_field_rule(type);
+	where &= town_area();
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		if(rule.blocked_by & eFieldType(f))
+			where -= fields[f];
+	if(rule.ground != eFieldGround::ANY) {
+		cBitboard bad_ground;
+		where.for_each([&](int x, int y) {
+			if(!ground_allows(type, x, y))
+				bad_ground.set(x,y);
+		});
+		where -= bad_ground;
 	}
-	else fields[x][y] &= ~WALL_FORCE;
-	return true;
+	if(rule.antimagic_odds > 0) {
+		// Areas of fields come from spells, so this draws from the combat stream like the rest of the spell.
+		cBitboard on_antimagic = where & fields[FIELD_ANTIMAGIC];
+		for(int x = 0; x < cBitboard::SIZE; x++)
+			if(on_antimagic.col[x])
+				where.col[x] &= ~on_antimagic.col[x] | get_ran_bits(on_antimagic.col[x], 1, rule.antimagic_odds, eRandStream::COMBAT);
+	}
+	for(int f = 0; f <= SPECIAL_ROAD; f++)
+		if(rule.displaces & eFieldType(f))
+			fields[f] -= where;
+	if(type == FIELD_QUICKFIRE && where.any())
+		quickfire_present = true;
+	fields[type] |= where;
+	return where;
 }
 
-bool cCurTown::set_fire_wall(short x, short y, bool b){
+bool cCurTown::remove_field(eFieldType type, short x, short y) {
 	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, there's no room for field.
-		if(is_impassable(x,y))
-			return false;
-		if(is_antimagic(x,y) || is_blade_wall(x,y) || is_quickfire(x,y) || is_ice_wall(x,y))
-			return false;
-		if(is_crate(x,y) || is_barrel(x,y) || is_fire_barr(x,y) || is_force_barr(x,y))
-			return false;
-		if(is_web(x,y) || is_scloud(x,y) || is_sleep_cloud(x,y))
-			return false;
-		set_web(x,y,false);
-		set_fire_wall(x,y,false);
-		fields[x][y]  |=  WALL_FIRE;
-	}
-	else fields[x][y] &= ~WALL_FIRE;
+	fields[type].set(x,y,false);
 	return true;
 }
 
+bool cCurTown::set_explored(short x, short y, bool b){
+	if(b) return place_field(SPECIAL_EXPLORED,x,y);
+	return remove_field(SPECIAL_EXPLORED,x,y);
+}
+
+bool cCurTown::set_force_wall(short x, short y, bool b){
+	if(b) return place_field(WALL_FORCE,x,y);
+	return remove_field(WALL_FORCE,x,y);
+}
+
+bool cCurTown::set_fire_wall(short x, short y, bool b){
+	if(b) return place_field(WALL_FIRE,x,y);
+	return remove_field(WALL_FIRE,x,y);
+}
+
 bool cCurTown::set_antimagic(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, there's no room for a field.
-		if(is_impassable(x,y))
-			return false;
-		if(is_quickfire(x,y) || is_force_wall(x,y) || is_fire_wall(x,y))
-			return false;
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		set_antimagic(x,y,false);
-		set_scloud(x,y,false);
-		set_ice_wall(x,y,false);
-		set_blade_wall(x,y,false);
-		set_sleep_cloud(x,y,false);
-		fields[x][y]  |=  FIELD_ANTIMAGIC;
-	}
-	else fields[x][y] &= ~FIELD_ANTIMAGIC;
-	return true;
+	if(b) return place_field(FIELD_ANTIMAGIC,x,y);
+	return remove_field(FIELD_ANTIMAGIC,x,y);
 }
 
 bool cCurTown::set_scloud(short x, short y, bool b){ // stinking cloud
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, there's no room for cloud.
-		if(is_impassable(x,y))
-			return false;
-		if(is_force_wall(x,y) || is_fire_wall(x,y) || is_ice_wall(x,y) || is_blade_wall(x,y))
-			return false;
-		if(is_antimagic(x,y) || is_sleep_cloud(x,y) || is_quickfire(x,y))
-			return false;
-		if(is_fire_barr(x,y) || is_force_barr(x,y))
-			return false;
-		fields[x][y]  |=  CLOUD_STINK;
-	}
-	else fields[x][y] &= ~CLOUD_STINK;
-	return true;
+	if(b) return place_field(CLOUD_STINK,x,y);
+	return remove_field(CLOUD_STINK,x,y);
 }
 
 bool cCurTown::set_ice_wall(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, ther's no room for a field.
-		if(is_impassable(x,y))
-			return false;
-		if(is_force_wall(x,y) || is_blade_wall(x,y) || is_antimagic(x,y))
-			return false;
-		if(is_web(x,y) || is_crate(x,y) || is_barrel(x,y))
-			return false;
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y))
-			return false;
-		set_fire_wall(x,y,false);
-		set_scloud(x,y,false);
-		fields[x][y]  |=  WALL_ICE;
-	}
-	else fields[x][y] &= ~WALL_ICE;
-	return true;
+	if(b) return place_field(WALL_ICE,x,y);
+	return remove_field(WALL_ICE,x,y);
 }
 
 bool cCurTown::set_blade_wall(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // if certain things are on space, there's no room for a field.
-		if(is_impassable(x,y))
-			return false;
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y) || is_antimagic(x,y))
-			return false;
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		fields[x][y]  |=  WALL_BLADES;
-	}
-	else fields[x][y] &= ~WALL_BLADES;
-	return true;
+	if(b) return place_field(WALL_BLADES,x,y);
+	return remove_field(WALL_BLADES,x,y);
 }
 
 bool cCurTown::set_sleep_cloud(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // if certain things are on space, there's no room for cloud.
-		if(is_impassable(x,y))
-			return false;
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y) || is_antimagic(x,y))
-			return false;
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		fields[x][y]  |=  CLOUD_SLEEP;
-	}
-	else fields[x][y] &= ~CLOUD_SLEEP;
-	return true;
+	if(b) return place_field(CLOUD_SLEEP,x,y);
+	return remove_field(CLOUD_SLEEP,x,y);
 }
 
 bool cCurTown::set_block(short x, short y, bool b){ // currently unused
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b) fields[x][y] |=  OBJECT_BLOCK;
-	else  fields[x][y] &= ~OBJECT_BLOCK;
-	return true;
+	if(b) return place_field(OBJECT_BLOCK,x,y);
+	return remove_field(OBJECT_BLOCK,x,y);
 }
 
 bool cCurTown::set_spot(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b) fields[x][y] |=  SPECIAL_SPOT;
-	else  fields[x][y] &= ~SPECIAL_SPOT;
-	return true;
+	if(b) return place_field(SPECIAL_SPOT,x,y);
+	return remove_field(SPECIAL_SPOT,x,y);
 }
 
 bool cCurTown::set_road(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b) fields[x][y] |=  SPECIAL_ROAD;
-	else  fields[x][y] &= ~SPECIAL_ROAD;
-	return true;
+	if(b) return place_field(SPECIAL_ROAD,x,y);
+	return remove_field(SPECIAL_ROAD,x,y);
 }
 
 bool cCurTown::set_web(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on the space, there's no room for webs
-		if(is_impassable(x,y))
-			return false;
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y))
-			return false;
-		if(is_force_wall(x,y) || is_fire_wall(x,y) || is_antimagic(x, y))
-			return false;
-		if(is_ice_wall(x, y) || is_blade_wall(x,y) || is_sleep_cloud(x,y))
-			return false;
-		fields[x][y]  |=  FIELD_WEB;
-	}
-	else fields[x][y] &= ~FIELD_WEB;
-	return true;
+	if(b) return place_field(FIELD_WEB,x,y);
+	return remove_field(FIELD_WEB,x,y);
 }
 
 bool cCurTown::set_crate(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on the space, there's no room for a crate.
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y) || is_barrel(x,y))
-			return false;
-		fields[x][y]  |=  OBJECT_CRATE;
-	}
-	else fields[x][y] &= ~OBJECT_CRATE;
-	return true;
+	if(b) return place_field(OBJECT_CRATE,x,y);
+	return remove_field(OBJECT_CRATE,x,y);
 }
 
 bool cCurTown::set_barrel(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on the space, there's no room for a crate.
-		if(is_fire_barr(x,y) || is_force_barr(x,y) || is_quickfire(x,y) || is_crate(x,y))
-			return false;
-		fields[x][y]  |=  OBJECT_BARREL;
-	}
-	else fields[x][y] &= ~OBJECT_BARREL;
-	return true;
+	if(b) return place_field(OBJECT_BARREL,x,y);
+	return remove_field(OBJECT_BARREL,x,y);
 }
 
 bool cCurTown::set_fire_barr(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on the space, there's no room for a barrier.
-		if(is_barrel(x,y) || is_force_barr(x,y) || is_quickfire(x,y) || is_crate(x,y))
-			return false;
-		if(is_antimagic(x,y) && get_ran(1,0,3) < 3)
-			return false;
-		// Cancel out fields
-		set_web(x,y,false);
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		set_antimagic(x,y,false);
-		set_scloud(x,y,false);
-		set_ice_wall(x,y,false);
-		set_blade_wall(x,y,false);
-		set_sleep_cloud(x,y,false);
-		fields[x][y]  |=  BARRIER_FIRE;
-	}
-	else fields[x][y] &= ~BARRIER_FIRE;
-	return true;
+	if(b) return place_field(BARRIER_FIRE,x,y);
+	return remove_field(BARRIER_FIRE,x,y);
 }
 
 bool cCurTown::set_force_barr(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on the space, there's no room for a barrier.
-		if(is_fire_barr(x,y) || is_barrel(x,y) || is_quickfire(x,y) || is_crate(x,y))
-			return false;
-		if(is_antimagic(x,y) && get_ran(1,0,2) < 2)
-			return false;
-		// Cancel out fields
-		set_web(x,y,false);
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		set_antimagic(x,y,false);
-		set_scloud(x,y,false);
-		set_ice_wall(x,y,false);
-		set_blade_wall(x,y,false);
-		set_sleep_cloud(x,y,false);
-		fields[x][y]  |=  BARRIER_FORCE;
-	}
-	else fields[x][y] &= ~BARRIER_FORCE;
-	return true;
+	if(b) return place_field(BARRIER_FORCE,x,y);
+	return remove_field(BARRIER_FORCE,x,y);
 }
 
 bool cCurTown::set_quickfire(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){ // If certain things are on space, there's no room for quickfire.
-		ter_num_t ter = record()->terrain(x,y);
-		if(univ.scenario.ter_types[ter].blockage == eTerObstruct::BLOCK_SIGHT)
-			return false;
-		// TODO: Isn't it a little odd that BLOCK_MOVE_AND_SHOOT isn't included here?
-		if(univ.scenario.ter_types[ter].blockage == eTerObstruct::BLOCK_MOVE_AND_SIGHT)
-			return false;
-		if(is_antimagic(x,y) && get_ran(1,0,1) == 0)
-			return false;
-		if(is_force_barr(x,y) || is_fire_barr(x,y))
-			return false;
-		quickfire_present = true;
-		set_force_wall(x,y,false);
-		set_fire_wall(x,y,false);
-		set_antimagic(x,y,false);
-		set_scloud(x,y,false);
-		set_ice_wall(x,y,false);
-		set_blade_wall(x,y,false);
-		set_sleep_cloud(x,y,false);
-		set_web(x,y,false);
-		set_crate(x,y,false);
-		set_barrel(x,y,false);
-		set_force_barr(x,y,false);
-		set_fire_barr(x,y,false);
-		fields[x][y]  |=  FIELD_QUICKFIRE;
-	}
-	else fields[x][y] &= ~FIELD_QUICKFIRE;
-	return true;
+	if(b) return place_field(FIELD_QUICKFIRE,x,y);
+	return remove_field(FIELD_QUICKFIRE,x,y);
 }
 
 bool cCurTown::free_for_sfx(short x, short y) {
@@ -601,151 +638,49 @@ bool cCurTown::free_for_sfx(short x, short y) {
 }
 
 bool cCurTown::set_sm_blood(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		if(is_med_blood(x,y) || is_lg_blood(x,y))
-			return false;
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_SMALL_BLOOD;
-	}
-	else fields[x][y] &= ~SFX_SMALL_BLOOD;
-	return true;
+	if(b) return place_field(SFX_SMALL_BLOOD,x,y);
+	return remove_field(SFX_SMALL_BLOOD,x,y);
 }
 
 bool cCurTown::set_med_blood(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		if(is_lg_blood(x,y))
-			return false;
-		set_sm_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_MEDIUM_BLOOD;
-	}
-	else fields[x][y] &= ~SFX_MEDIUM_BLOOD;
-	return true;
+	if(b) return place_field(SFX_MEDIUM_BLOOD,x,y);
+	return remove_field(SFX_MEDIUM_BLOOD,x,y);
 }
 
 bool cCurTown::set_lg_blood(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_LARGE_BLOOD;
-	}
-	else fields[x][y] &= ~SFX_LARGE_BLOOD;
-	return true;
+	if(b) return place_field(SFX_LARGE_BLOOD,x,y);
+	return remove_field(SFX_LARGE_BLOOD,x,y);
 }
 
 bool cCurTown::set_sm_slime(short x, short y, bool b){
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		if(is_lg_slime(x,y))
-			return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_lg_blood(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_SMALL_SLIME;
-	}
-	else fields[x][y] &= ~SFX_SMALL_SLIME;
-	return true;
+	if(b) return place_field(SFX_SMALL_SLIME,x,y);
+	return remove_field(SFX_SMALL_SLIME,x,y);
 }
 
 bool cCurTown::set_lg_slime(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_lg_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_LARGE_SLIME;
-	}
-	else fields[x][y] &= ~SFX_LARGE_SLIME;
-	return true;
+	if(b) return place_field(SFX_LARGE_SLIME,x,y);
+	return remove_field(SFX_LARGE_SLIME,x,y);
 }
 
 bool cCurTown::set_ash(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_lg_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_bones(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_ASH;
-	}
-	else fields[x][y] &= ~SFX_ASH;
-	return true;
+	if(b) return place_field(SFX_ASH,x,y);
+	return remove_field(SFX_ASH,x,y);
 }
 
 bool cCurTown::set_bones(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_lg_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_ash(x,y,false);
-		set_rubble(x,y,false);
-		fields[x][y]  |=  SFX_BONES;
-	}
-	else fields[x][y] &= ~SFX_BONES;
-	return true;
+	if(b) return place_field(SFX_BONES,x,y);
+	return remove_field(SFX_BONES,x,y);
 }
 
 bool cCurTown::set_rubble(short x, short y, bool b){
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b){
-		if(!free_for_sfx(x,y)) return false;
-		set_sm_blood(x,y,false);
-		set_med_blood(x,y,false);
-		set_lg_blood(x,y,false);
-		set_sm_slime(x,y,false);
-		set_lg_slime(x,y,false);
-		set_ash(x,y,false);
-		set_bones(x,y,false);
-		fields[x][y]  |=  SFX_RUBBLE;
-	}
-	else fields[x][y] &= ~SFX_RUBBLE;
-	return true;
+	if(b) return place_field(SFX_RUBBLE,x,y);
+	return remove_field(SFX_RUBBLE,x,y);
 }
 
 bool cCurTown::set_force_cage(short x, short y, bool b){
-	// TODO: Consider whether placing a forcecage should erase anything already present, or fail due to something already present
-	// TODO: Also consider checking for forcecage in some of the other placement functions.
-	if(x > record()->max_dim() || y > record()->max_dim()) return false;
-	if(b) fields[x][y] |=  BARRIER_CAGE;
-	else  fields[x][y] &= ~BARRIER_CAGE;
-	return true;
+	if(b) return place_field(BARRIER_CAGE,x,y);
+	return remove_field(BARRIER_CAGE,x,y);
 }
-
 // TODO: This seems to be wrong; impassable implies "blocks movement", which two other blockages also do
 bool cCurTown::is_impassable(short i,short  j) {
 	ter_num_t ter;
@@ -809,7 +744,11 @@ void cCurTown::writeTo(std::ostream& file) const {
 	file << '\f';
 	file << "FIELDS\n";
 	file << std::hex;
-	writeArray(file, fields, record()->max_dim(), record()->max_dim());
+	unsigned long packed[64][64];
+	for(int i = 0; i < record()->max_dim(); i++)
+		for(int j = 0; j < record()->max_dim(); j++)
+			packed[i][j] = get_fields(i,j);
+	writeArray(file, packed, record()->max_dim(), record()->max_dim());
 	file << std::dec;
 	file << "TERRAIN\n";
 	record()->writeTerrainTo(file);
@@ -844,7 +783,12 @@ void cCurTown::readFrom(std::istream& file){
 		bin >> cur;
 		if(cur == "FIELDS") {
 			bin >> std::hex;
-			readArray(bin, fields, univ.scenario.towns[num]->max_dim(), univ.scenario.towns[num]->max_dim());
+			unsigned long packed[64][64] = {};
+			int dim = univ.scenario.towns[num]->max_dim();
+			readArray(bin, packed, dim, dim);
+			for(int i = 0; i < dim; i++)
+				for(int j = 0; j < dim; j++)
+					set_fields(i, j, packed[i][j]);
 			bin >> std::dec;
 		} else if(cur == "ITEM") {
 			int i;
@@ -866,9 +810,6 @@ void cCurTown::readFrom(std::istream& file){
 cCurTown::cCurTown(cUniverse& univ) : univ(univ) {
 	arena = nullptr;
 	num = 200;
-	for(int i = 0; i < 64; i++)
-		for(int j = 0; j < 64; j++)
-			fields[i][j] = 0L;
 }
 
 cCurOut::cCurOut(cUniverse& univ) : univ(univ) {}
@@ -896,6 +837,23 @@ bool cCurOut::is_road(int x, int y) {
 	return univ.scenario.outdoors[sector_x][sector_y]->roads[x][y];
 }
 
+void cCurOut::shift(int dx, int dy) {
+	if(dx != 0) {
+		int from = dx > 0 ? 48 : 0, to = 48 - from;
+		std::copy(&out[from][0], &out[from][0] + 48 * 96, &out[to][0]);
+		std::copy(&out_e[from][0], &out_e[from][0] + 48 * 96, &out_e[to][0]);
+		std::fill(&out_e[from][0], &out_e[from][0] + 48 * 96, 0);
+	}
+	if(dy != 0) {
+		int from = dy > 0 ? 48 : 0, to = 48 - from;
+		for(int x = 0; x < 96; x++) {
+			std::copy(out[x] + from, out[x] + from + 48, out[x] + to);
+			std::copy(out_e[x] + from, out_e[x] + from + 48, out_e[x] + to);
+			std::fill(out_e[x] + from, out_e[x] + from + 48, 0);
+		}
+	}
+}
+
 cUniverse::cUniverse(long party_type) : party(*this, party_type), out(*this), town(*this) {}
 
 void cUniverse::check_monst(cMonster& monst) {
@@ -13,10 +13,13 @@
 #include <memory>
 #include <set>
 #include <array>
+#include <map>
+#include <bitset>
 #include <boost/filesystem/path.hpp>
 #include "party.hpp"
 #include "creatlist.hpp"
 #include "item.hpp"
+#include "bitboard.hpp"
 #include "town.hpp"
 #include "talking.hpp"
 #include "simpletypes.hpp"
@@ -37,6 +40,8 @@ namespace legacy {
 class cCurTown {
 	short cur_talk_loaded = -1;
 	bool free_for_sfx(short x, short y);
+	bool ground_allows(eFieldType type, short x, short y);
+	bool remove_field(eFieldType type, short x, short y);
 	cUniverse& univ;
 	cTown* arena;
 	cTown*const record() const;
@@ -51,7 +56,9 @@ public:
 	
 	std::vector<cItem> items; // formerly town_item_list type
 	
-	unsigned long fields[64][64];
+	// One plane per field type, indexed by eFieldType.
+	// Whole-town field effects (spreading, dispelling, area placement) work a column at a time on these.
+	cBitboard fields[SPECIAL_ROAD + 1];
 	
 	void append(legacy::current_town_type& old);
 	void append(legacy::town_item_list& old);
@@ -66,6 +73,16 @@ public:
 	void prep_arena(); // Set up for a combat arena
 	void place_preset_fields();
 	
+	// Packed view of all fields on a space, with one bit per eFieldType
+	unsigned long get_fields(short x, short y) const;
+	void set_fields(short x, short y, unsigned long mask);
+	void clear_fields();
+	cBitboard town_area() const;
+	// Places a field if the space allows it, following the same rules as the set_* functions
+	bool place_field(eFieldType type, short x, short y);
+	// Places a field on every allowed space in the area, returning the spaces where it was placed
+	cBitboard place_fields(eFieldType type, cBitboard where);
+	
 	bool is_explored(short x, short y) const;
 	bool is_force_wall(short x, short y) const;
 	bool is_fire_wall(short x, short y) const;
@@ -126,6 +143,40 @@ public:
 	~cCurTown();
 };
 
+// Which spaces of each town, or each outdoor sector, the party has explored; one bit per space.
+// A map takes no memory until something in it is explored, and only those maps are saved.
+template<int dim> class cExploredMaps {
+	std::map<size_t,std::bitset<dim * dim>> maps;
+public:
+	bool isExplored(size_t which, int x, int y) const {
+		auto iter = maps.find(which);
+		return iter != maps.end() && iter->second[x * dim + y];
+	}
+	void explore(size_t which, int x, int y) {
+		maps[which].set(x * dim + y);
+	}
+	void exploreAll(size_t which) {
+		maps[which].set();
+	}
+	void clear() {
+		maps.clear();
+	}
+	size_t size() const {
+		return maps.size();
+	}
+	// The old fixed-size format, where space x,y is bit x % 8 of byte [x / 8][y]
+	template<typename Byte> void append(size_t which, const Byte(& old)[dim / 8][dim]) {
+		for(int x = 0; x < dim; x++)
+			for(int y = 0; y < dim; y++)
+				if(old[x / 8][y] & (1 << x % 8))
+					explore(which, x, y);
+	}
+	// Reads count maps in the old format, one after the other
+	void readLegacy(std::istream& file, size_t count);
+	void writeTo(std::ostream& file) const;
+	void readFrom(std::istream& file);
+};
+
 class cCurOut {
 	cUniverse& univ;
 public:
@@ -136,6 +187,9 @@ public:
 	// These take global coords (ie 0..95)
 	bool is_spot(int x, int y);
 	bool is_road(int x, int y);
+	// Moves the sector that stays loaded to the opposite side when the window moves by dx,dy sectors.
+	// The incoming side is left unexplored, with its terrain still to be loaded.
+	void shift(int dx, int dy);
 	
 	void append(legacy::out_info_type& old);
 	
@@ -177,9 +231,9 @@ public:
 	cParty party;
 	std::map<long,cPlayer*> stored_pcs;
 	cCurTown town;
-	unsigned char town_maps[200][8][64]; // formerly stored_town_maps_type
+	cExploredMaps<64> town_maps; // formerly stored_town_maps_type
 	cCurOut out;
-	unsigned char out_maps[100][6][48]; // formerly stored_outdoor_maps_type
+	cExploredMaps<48> out_maps; // formerly stored_outdoor_maps_type
 	fs::path file;
 	bool debug_mode, ghost_mode, node_step_through;
 	
@@ -195,11 +195,11 @@ void cControl::redraw() {
 bool cControl::handleClick(location){
 	sf::Event e;
 	bool done = false, clicked = false;
-	inWindow->setActive();
+	if(!cDialog::replayInput) inWindow->setActive();
 	depressed = true;
 	while(!done){
 		redraw();
-		if(!inWindow->pollEvent(e)) continue;
+		if(!cDialog::pollInput(*inWindow, e)) continue;
 		if(e.type == sf::Event::MouseButtonReleased){
 			done = true;
 			clicked = frame.contains(e.mouseButton.x, e.mouseButton.y);
@@ -209,7 +209,9 @@ bool cControl::handleClick(location){
 			depressed = frame.contains(e.mouseMove.x, e.mouseMove.y);
 		}
 	}
-	if(get_bool_pref("PlaySounds", true)) {
+	if(cDialog::replayInput) {
+		// There's nothing to see, so no need to wait for it
+	} else if(get_bool_pref("PlaySounds", true)) {
 		if(typeid(this) == typeid(cLed*))
 			play_sound(34);
 		else play_sound(37);
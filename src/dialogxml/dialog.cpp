@@ -7,7 +7,10 @@
  */
 
 #include <cmath>
+#include <ctime>
+#include <memory>
 #include <stdexcept>
+#include <boost/filesystem.hpp>
 #include "dialog.hpp"
 #include "graphtool.hpp"
 #include "soundtool.hpp"
@@ -172,6 +175,30 @@ cDialog::cDialog(std::string path, cDialog* p) : parent(p) {
 	loadFromFile(path + ".xml");
 }
 
+// A parsed dialog definition, and the modification time of the file it came from
+struct dlog_template_t {
+	std::time_t mtime;
+	std::shared_ptr<const TiXmlDocument> xml;
+};
+static std::map<std::string,dlog_template_t> dlog_templates;
+
+// Each dialog file is only read and parsed once, unless it's changed since.
+// The template itself is never handed out, as ticpp leaves wrappers attached to every node it visits.
+static std::shared_ptr<const TiXmlDocument> load_dialog_template(fs::path path) {
+	boost::system::error_code err;
+	std::time_t mtime = fs::last_write_time(path, err);
+	auto iter = dlog_templates.find(path.string());
+	if(!err && iter != dlog_templates.end() && iter->second.mtime == mtime)
+		return iter->second.xml;
+	TiXmlBase::SetCondenseWhiteSpace(false);
+	std::shared_ptr<TiXmlDocument> parsed(new TiXmlDocument(path.string()));
+	// Wrapping it only to get ticpp's exceptions; the wrapper doesn't take ownership.
+	Document(parsed.get()).LoadFile();
+	if(!err)
+		dlog_templates[path.string()] = {mtime, parsed};
+	return parsed;
+}
+
 extern fs::path progDir;
 void cDialog::loadFromFile(std::string path){
 	static const cKey enterKey = {true, key_enter};
@@ -179,9 +206,8 @@ void cDialog::loadFromFile(std::string path){
 	fname = path;
 	fs::path cPath = progDir/"data"/"dialogs"/path;
 	try{
-		TiXmlBase::SetCondenseWhiteSpace(false);
-		Document xml(cPath.string().c_str());
-		xml.LoadFile();
+		TiXmlDocument copy(*load_dialog_template(cPath));
+		Document xml(&copy);
 		
 		Iterator<Attribute> attr;
 		Iterator<Element> node;
@@ -383,11 +409,14 @@ bool cDialog::sendInput(cKey key) {
 }
 
 void cDialog::run(std::function<void(cDialog&)> onopen){
+	if(onRun) onRun(fname);
+	// A replay shows nothing, so it needs no window, cursor or pauses
+	bool replaying = bool(replayInput);
 	cDialog* formerTop = topWindow;
 	// TODO: The introduction of the static topWindow means I may be able to use this instead of parent->win; do I still need parent?
 	sf::RenderWindow* parentWin = &(parent ? parent->win : mainPtr);
 	cursor_type former_curs = current_cursor;
-	set_cursor(sword_curs);
+	if(!replaying) set_cursor(sword_curs);
 	using kb = sf::Keyboard;
 	kb::Key k;
 	cKey key, pendingKey = {true};
@@ -404,26 +433,45 @@ void cDialog::run(std::function<void(cDialog&)> onopen){
 			currentFocus = iter->first;
 		}
 	}
-	// Sometimes it seems like the Cocoa menu handling clobbers the active rendering context.
-	// For whatever reason, delaying 100 milliseconds appears to fix this.
-	sf::sleep(sf::milliseconds(100));
-	// So this little section of code is a real-life valley of dying things.
-	// Instantiating a window and then closing it seems to fix the update error, because magic.
-	win.create(sf::VideoMode(1,1),"");
-	win.close();
-	win.create(sf::VideoMode(winRect.width(), winRect.height()), "Dialog", sf::Style::Titlebar);
-	draw();
-	makeFrontWindow(parent ? parent-> win : mainPtr);
-	makeFrontWindow(win);
-	// This is a loose modal session, as it doesn't prevent you from clicking away,
-	// but it does prevent editing other dialogs, and it also keeps this window on top
-	// even when it loses focus.
-	ModalSession dlog(win, *parentWin);
+	std::unique_ptr<ModalSession> dlog;
+	if(!replaying) {
+		// Sometimes it seems like the Cocoa menu handling clobbers the active rendering context.
+		// For whatever reason, delaying 100 milliseconds appears to fix this.
+		sf::sleep(sf::milliseconds(100));
+		// So this little section of code is a real-life valley of dying things.
+		// Instantiating a window and then closing it seems to fix the update error, because magic.
+		win.create(sf::VideoMode(1,1),"");
+		win.close();
+		win.create(sf::VideoMode(winRect.width(), winRect.height()), "Dialog", sf::Style::Titlebar);
+		draw();
+		makeFrontWindow(parent ? parent-> win : mainPtr);
+		makeFrontWindow(win);
+		// This is a loose modal session, as it doesn't prevent you from clicking away,
+		// but it does prevent editing other dialogs, and it also keeps this window on top
+		// even when it loses focus.
+		dlog.reset(new ModalSession(win, *parentWin));
+	}
 	if(onopen) onopen(*this);
 	animTimer.restart();
+	// Only redraw after an event, or now and then for animations and the blinking insertion point
+	static const sf::Time anim_interval = sf::milliseconds(100), idle_wait = sf::milliseconds(50);
+	sf::Clock sinceDraw;
+	bool damaged = true;
 	while(dialogNotToast){
-		draw();
-		if(!win.pollEvent(currentEvent)) continue;
+		if(replaying)
+			replayInput(currentEvent, heldMods);
+		else {
+			bool animating = doAnimations || !currentFocus.empty();
+			if(damaged || (animating && sinceDraw.getElapsedTime() >= anim_interval)) {
+				draw();
+				sinceDraw.restart();
+				damaged = false;
+			}
+			if(!wait_for_event(win, currentEvent, animating ? std::min(idle_wait, anim_interval - sinceDraw.getElapsedTime()) : idle_wait))
+				continue;
+			noteInput(currentEvent);
+		}
+		damaged = true;
 		location where;
 		switch(currentEvent.type){
 			case sf::Event::KeyPressed:
@@ -535,15 +583,7 @@ void cDialog::run(std::function<void(cDialog&)> onopen){
 				}
 				break;
 			case sf::Event::MouseButtonPressed:
-				key.mod = mod_none;
-				if(kb::isKeyPressed(kb::LControl)) key.mod += mod_ctrl;
-				if(kb::isKeyPressed(kb::RControl)) key.mod += mod_ctrl;
-				if(kb::isKeyPressed(kb::LSystem)) key.mod += mod_ctrl;
-				if(kb::isKeyPressed(kb::RSystem)) key.mod += mod_ctrl;
-				if(kb::isKeyPressed(kb::LAlt)) key.mod += mod_alt;
-				if(kb::isKeyPressed(kb::RAlt)) key.mod += mod_alt;
-				if(kb::isKeyPressed(kb::LShift)) key.mod += mod_shift;
-				if(kb::isKeyPressed(kb::RShift)) key.mod += mod_shift;
+				key.mod = heldMods;
 				where = {currentEvent.mouseButton.x, currentEvent.mouseButton.y};
 				process_click(where, key.mod);
 				break;
@@ -551,6 +591,8 @@ void cDialog::run(std::function<void(cDialog&)> onopen){
 				break;
 			case sf::Event::GainedFocus:
 			case sf::Event::MouseMoved:
+				// The cursor is all this changes, and a replay has none
+				if(replaying) break;
 				bool inField = false;
 				for(auto& ctrl : controls) {
 					if(ctrl.second->getType() == CTRL_FIELD && ctrl.second->getBounds().contains(currentEvent.mouseMove.x, currentEvent.mouseMove.y)) {
@@ -563,13 +605,48 @@ void cDialog::run(std::function<void(cDialog&)> onopen){
 				break;
 		}
 	}
+	topWindow = formerTop;
+	if(replaying) return;
 	win.setVisible(false);
 	while(parentWin->pollEvent(currentEvent));
 	set_cursor(former_curs);
-	topWindow = formerTop;
 	makeFrontWindow(*parentWin);
 }
 
+// Which modifier keys are down right now
+static eKeyMod current_mods() {
+	using kb = sf::Keyboard;
+	eKeyMod mods = mod_none;
+	if(kb::isKeyPressed(kb::LControl)) mods += mod_ctrl;
+	if(kb::isKeyPressed(kb::RControl)) mods += mod_ctrl;
+	if(kb::isKeyPressed(kb::LSystem)) mods += mod_ctrl;
+	if(kb::isKeyPressed(kb::RSystem)) mods += mod_ctrl;
+	if(kb::isKeyPressed(kb::LAlt)) mods += mod_alt;
+	if(kb::isKeyPressed(kb::RAlt)) mods += mod_alt;
+	if(kb::isKeyPressed(kb::LShift)) mods += mod_shift;
+	if(kb::isKeyPressed(kb::RShift)) mods += mod_shift;
+	return mods;
+}
+
+void cDialog::noteInput(const sf::Event& event) {
+	heldMods = current_mods();
+	if(onInput) onInput(event, heldMods);
+}
+
+bool cDialog::pollInput(sf::Window& win, sf::Event& event) {
+	if(replayInput) {
+		replayInput(event, heldMods);
+		return true;
+	}
+	if(!win.pollEvent(event)) return false;
+	noteInput(event);
+	return true;
+}
+
+eKeyMod cDialog::inputMods() {
+	return heldMods;
+}
+
 template<typename Iter> void cDialog::handleTabOrder(string& itemHit, Iter begin, Iter end) {
 	auto cur = find_if(begin, end, [&itemHit](pair<string,cTextField*>& a) {
 		return a.first == itemHit;
@@ -713,18 +790,21 @@ void cDialog::process_keystroke(cKey keyHit){
 	ctrlIter iter = controls.begin();
 	while(iter != controls.end()){
 		if(iter->second->isVisible() && iter->second->isClickable() && iter->second->getAttachedKey() == keyHit){
-			iter->second->setActive(true);
-			draw();
-			if(get_bool_pref("PlaySounds", true)) {
-				if(typeid(iter->second) == typeid(cLed*))
-					play_sound(34);
-				else play_sound(37);
-				sf::sleep(time_in_ticks(6));
+			// Flash the control, unless it's a replay with nothing to see
+			if(!replayInput) {
+				iter->second->setActive(true);
+				draw();
+				if(get_bool_pref("PlaySounds", true)) {
+					if(typeid(iter->second) == typeid(cLed*))
+						play_sound(34);
+					else play_sound(37);
+					sf::sleep(time_in_ticks(6));
+				}
+				else sf::sleep(time_in_ticks(14));
+				iter->second->setActive(false);
+				draw();
+				sf::sleep(sf::milliseconds(8));
 			}
-			else sf::sleep(time_in_ticks(14));
-			iter->second->setActive(false);
-			draw();
-			sf::sleep(sf::milliseconds(8));
 			iter->second->triggerClickHandler(*this,iter->first,mod_none);
 			return;
 		}
@@ -879,8 +959,13 @@ xBadVal::~xBadVal() throw(){
 }
 
 bool cDialog::doAnimations = false;
+std::function<void(const std::string&)> cDialog::onRun;
+std::function<void(const sf::Event&,eKeyMod)> cDialog::onInput;
+std::function<void(sf::Event&,eKeyMod&)> cDialog::replayInput;
+eKeyMod cDialog::heldMods = mod_none;
 
 void cDialog::draw(){
+	if(replayInput) return;
 	win.setActive();
 	tileImage(win,winRect,::bg[bg]);
 	if(doAnimations && animTimer.getElapsedTime().asMilliseconds() >= 500) {
@@ -194,6 +194,23 @@ public:
 	static bool sendInput(cKey key);
 	/// Sets whether to animate graphics in dialogs.
 	static bool doAnimations;
+	/// If set, called with the name of the dialog's definition whenever a dialog is about to run.
+	/// It may throw to keep the dialog from opening at all.
+	static std::function<void(const std::string&)> onRun;
+	/// If set, called with each input event a dialog takes, along with the modifier keys held at the time.
+	static std::function<void(const sf::Event&,eKeyMod)> onInput;
+	/// If set, dialogs open no window and draw nothing, and take their input from this instead.
+	/// It should fill in the next event and the modifier keys held for it, or throw if there are none left.
+	static std::function<void(sf::Event&,eKeyMod&)> replayInput;
+	/// Get the next input event for a dialog, either from its window or from the replay.
+	/// Controls that follow the mouse after a click should take their events from here.
+	/// @param win The window the input is for.
+	/// @param event Set to the event.
+	/// @return false if there was no event waiting.
+	static bool pollInput(sf::Window& win, sf::Event& event);
+	/// Get the modifier keys held when the input last returned by pollInput() happened.
+	/// @return The modifier keys.
+	static eKeyMod inputMods();
 	/// Adds a new control described by the passed XML element.
 	/// @tparam Ctrl The type of control to add.
 	/// @param who The XML element describing the control.
@@ -216,6 +233,8 @@ private:
 	void draw();
 	void process_keystroke(cKey keyHit);
 	void process_click(location where, eKeyMod mods);
+	static void noteInput(const sf::Event& event);
+	static eKeyMod heldMods;
 	bool dialogNotToast, didAccept;
 	rectangle winRect;
 	boost::any result;
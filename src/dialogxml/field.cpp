@@ -124,7 +124,7 @@ bool cTextField::handleClick(location clickLoc) {
 	bool hadSelection = selectionPoint != insertionPoint;
 	bool is_double = click_timer.getElapsedTime().asMilliseconds() < 500;
 	click_timer.restart();
-	bool is_shift = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+	bool is_shift = mod_contains(cDialog::inputMods(), mod_shift);
 	set_ip(clickLoc, is_shift ? &cTextField::selectionPoint : &cTextField::insertionPoint);
 	if(!is_shift) selectionPoint = insertionPoint;
 	if(is_double && !is_shift && !hadSelection) {
@@ -140,7 +140,7 @@ bool cTextField::handleClick(location clickLoc) {
 	int initial_ip = insertionPoint, initial_sp = selectionPoint;
 	while(!done) {
 		redraw();
-		if(!inWindow->pollEvent(e)) continue;
+		if(!cDialog::pollInput(*inWindow, e)) continue;
 		if(e.type == sf::Event::MouseButtonReleased){
 			done = true;
 		} else if(e.type == sf::Event::MouseMoved){
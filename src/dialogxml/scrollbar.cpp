@@ -106,10 +106,15 @@ bool cScrollbar::handleClick(location where) {
 		pressedPart = PART_PGDN;
 	else pressedPart = PART_DOWN;
 	int diff = clickPos - thumbPos;
+	sf::Vector2i mouseLoc(where.x, where.y);
 	while(!done){
 		redraw();
-		if(!inWindow->pollEvent(e)) continue;
-		sf::Vector2i mouseLoc = sf::Mouse::getPosition(*inWindow);
+		if(!cDialog::pollInput(*inWindow, e)) continue;
+		// Go by where the event says the mouse was, so that replaying the events drags the same way
+		if(e.type == sf::Event::MouseMoved)
+			mouseLoc = {e.mouseMove.x, e.mouseMove.y};
+		else if(e.type == sf::Event::MouseButtonReleased)
+			mouseLoc = {e.mouseButton.x, e.mouseButton.y};
 		int mousePos = vert ? mouseLoc.y : mouseLoc.x;
 		if(e.type == sf::Event::MouseButtonReleased){
 			done = true;
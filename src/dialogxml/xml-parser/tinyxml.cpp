@@ -160,6 +160,7 @@ void TiXmlNode::CopyTo( TiXmlNode* target ) const
 {
 	target->SetValue (value.c_str() );
 	target->userData = userData;
+	target->location = location;
 }
 
 
@@ -833,6 +834,9 @@ void TiXmlElement::CopyTo( TiXmlElement* target ) const
 	attribute = attribute->Next() )
 	{
 		target->SetAttribute( attribute->Name(), attribute->Value() );
+		TiXmlAttribute* copy = target->attributeSet.Find( attribute->Name() );
+		if ( copy )
+			copy->location = attribute->location;
 	}
 
 	TiXmlNode* node = 0;
@@ -140,7 +140,7 @@ void edit_day() {
 	
 	long long dialog_answer = minmax(0,500,dlog.getResult<long long>());
 	
-	univ.party.age = (long long) (3700) * (long long) (dialog_answer);
+	univ.party.shift_age(3700 * long(dialog_answer) - long(univ.party.age));
 }
 
 void give_gold(short amount,bool /*print_result*/) {
@@ -266,7 +266,7 @@ void display_alchemy(bool allowEdit,cDialog* parent) {
 // MARK: Start spend XP dialog
 
 struct xp_dlog_state {
-	std::map<eSkill,short> skills;
+	decltype(cPlayer::skills) skills;
 	int who, mode;
 	int hp, sp, g, skp;
 };
@@ -16,6 +16,7 @@
 #include "strdlog.hpp"
 #include "choicedlog.hpp"
 #include "fileio.hpp"
+#include "prng.hpp"
 #include "pc.menus.hpp"
 #include "winutil.hpp"
 #include "cursors.hpp"
@@ -109,6 +110,7 @@ void Initialize(void) {
 	//	will always be different.  Don’t for each call of Random, or the sequence
 	//	will no longer be random.  Only needed once, here in the init.
 	srand(time(nullptr));
+	seed_random(time(nullptr));
 	
 	//	Make a new window for drawing in, and it must be a color window.
 	//	The window is full screen size, made smaller to make it more visible.
@@ -163,7 +165,7 @@ static void display_strings(short nstr, pic_num_t pic) {
 }
 
 void handle_menu_choice(eMenu item_hit) {
-	int i,j,k;
+	int i;
 	fs::path file;
 	switch(item_hit) {
 		case eMenu::NONE: break;
@@ -285,17 +287,13 @@ void handle_menu_choice(eMenu item_hit) {
 			break;
 		case eMenu::ADD_OUT_MAPS:
 			display_strings(13,15);
-			for(i = 0; i < 100; i++)
-				for(j = 0; j < 6; j++)
-					for(k = 0; k < 48; k++)
-						univ.out_maps[i][j][k] = 255;
+			for(i = 0; i < univ.scenario.outdoors.width() * univ.scenario.outdoors.height(); i++)
+				univ.out_maps.exploreAll(i);
 			break;
 		case eMenu::ADD_TOWN_MAPS:
 			display_strings(14,15);
-			for(i = 0; i < 200; i++)
-				for(j = 0; j < 8; j++)
-					for(k = 0; k < 64; k++)
-						univ.town_maps[i][j][k] = 255;
+			for(i = 0; i < univ.scenario.towns.size(); i++)
+				univ.town_maps.exploreAll(i);
 			break;
 		case eMenu::EDIT_MAGE:
 			display_pc(current_active_pc,10,0);
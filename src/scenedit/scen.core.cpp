@@ -1146,7 +1146,7 @@ static void save_monst_abil_detail(cDialog& me, eMonstAbil abil, uAbility& detai
 static bool edit_monst_abil_detail(cDialog& me, std::string hit, cMonster& monst) {
 	eMonstAbil abil;
 	uAbility abil_params;
-	std::map<eMonstAbil,uAbility>::iterator iter;
+	cMonstAbilities::iterator iter;
 	if(me[hit].getText() == "Add") {
 		int i = choose_text_res("monster-abilities", 1, 70, 0, &me, "Select an ability to add.");
 		if(i < 0) return true;
@@ -1379,6 +1379,7 @@ cMonster edit_monst_abil(cMonster initial,short which,cDialog& parent) {
 	put_monst_abils_in_dlog(monst_dlg, initial);
 	
 	monst_dlg.run();
+	initial.planTurn();
 	return initial;
 }
 
@@ -16,6 +16,7 @@
 #include "scen.core.hpp"
 #include "scen.keydlgs.hpp"
 #include "mathutil.hpp"
+#include "prng.hpp"
 #include "fileio.hpp"
 #include "scrollbar.hpp"
 #include "winutil.hpp"
@@ -126,6 +127,7 @@ void init_scened(int argc, char* argv[]) {
 		init_current_terrain();
 		check_for_intel();
 		srand(time(nullptr));
+		seed_random(time(nullptr));
 		
 		cen_x = 18;
 		cen_y = 18;
@@ -0,0 +1,23 @@
+
+#include "cursors.hpp"
+
+// For builds with no display, such as the combat simulator; there's never a cursor to show.
+
+extern cursor_type current_cursor;
+
+Cursor::Cursor(fs::path, float, float) : ptr(nullptr) {}
+
+Cursor::~Cursor() {}
+
+void Cursor::apply() {}
+
+void obscureCursor() {}
+
+void set_cursor(cursor_type which_c) {
+	if(which_c != watch_curs)
+		current_cursor = which_c;
+}
+
+void restore_cursor() {
+	set_cursor(current_cursor);
+}
@@ -0,0 +1,102 @@
+//
+//  enum_map.hpp
+//  BoE
+//
+//  A fixed-size array indexed by an enum, with a map-like interface.
+//
+
+#ifndef BoE_ENUM_MAP_HPP
+#define BoE_ENUM_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+// Stands in for std::map<Enum,Type> where the enum's values are a small dense range (0 .. Size-1).
+// Unlike the map, reading a key never allocates, and copying is a plain copy of the array.
+// Keys outside the range read as Type() and discard writes, which matches what the map did
+// for them in practice (they were never saved).
+template<typename Enum, typename Type, int Size> class enum_map {
+	// The extra element past the end is the scratch slot for out-of-range keys.
+	Type data[Size + 1];
+	static int index(Enum key) {
+		int i = int(key);
+		return i >= 0 && i < Size ? i : Size;
+	}
+public:
+	class const_iterator {
+		friend class enum_map<Enum, Type, Size>;
+		const Type* data;
+		int i;
+		const_iterator(const Type* data, int i) : data(data), i(i) {}
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef std::pair<Enum, Type> value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const value_type* pointer;
+		typedef value_type reference;
+		std::pair<Enum, Type> operator*() const {
+			return {Enum(i), data[i]};
+		}
+		const_iterator& operator++() {
+			i++;
+			return *this;
+		}
+		const_iterator operator++(int) {
+			const_iterator old = *this;
+			i++;
+			return old;
+		}
+		bool operator==(const const_iterator& other) const {
+			return data == other.data && i == other.i;
+		}
+		bool operator!=(const const_iterator& other) const {
+			return !(*this == other);
+		}
+	};
+	enum_map() : data() {}
+	Type& operator[](Enum key) {
+		int i = index(key);
+		if(i == Size) data[Size] = Type();
+		return data[i];
+	}
+	const Type& operator[](Enum key) const {
+		static const Type none = Type();
+		int i = index(key);
+		return i == Size ? none : data[i];
+	}
+	Type& at(Enum key) {
+		if(index(key) == Size) throw std::out_of_range("enum_map::at");
+		return data[int(key)];
+	}
+	const Type& at(Enum key) const {
+		if(index(key) == Size) throw std::out_of_range("enum_map::at");
+		return data[int(key)];
+	}
+	void clear() {
+		std::fill(data, data + Size + 1, Type());
+	}
+	// Bit i is set if the value at key i is not Type(); lets callers skip entries that are all clear.
+	unsigned long nonzero() const {
+		unsigned long mask = 0;
+		for(int i = 0; i < Size; i++)
+			if(data[i] != Type()) mask |= 1ul << i;
+		return mask;
+	}
+	bool any() const {
+		return nonzero() != 0;
+	}
+	size_t size() const {
+		return Size;
+	}
+	const_iterator begin() const {
+		return const_iterator(data, 0);
+	}
+	const_iterator end() const {
+		return const_iterator(data, Size);
+	}
+};
+
+#endif
@@ -33,7 +33,9 @@ void init_directories(const char* exec_path) {
 #ifdef __APPLE__
 	// Need to back up out of the application package
 	// We're pointing at .app/Contents/MacOS/exec_name, so back out three steps
-	progDir = progDir.parent_path().parent_path().parent_path();
+	// (The combat simulator isn't in a package, though.)
+	if(progDir.parent_path().filename() == "MacOS")
+		progDir = progDir.parent_path().parent_path().parent_path();
 #endif
 	progDir = progDir.parent_path();
 	// Initialize the resource manager paths
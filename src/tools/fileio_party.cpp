@@ -18,6 +18,7 @@
 #include "graphtool.hpp"
 
 #include "porting.hpp"
+#include "prng.hpp"
 #include "tarball.hpp"
 
 extern bool mac_is_intel;
@@ -283,6 +284,10 @@ bool load_party_v2(fs::path file_to_load, cUniverse& univ){
 		univ.party.readFrom(fin);
 	}
 	
+	// Saves from before the random number streams were saved just keep the current ones
+	if(partyIn.hasFile("save/random.txt"))
+		read_random_state(partyIn.getFile("save/random.txt"));
+	
 	{ // Then the "setup" array
 		std::istream& fin = partyIn.getFile("save/setup.dat");
 		if(!fin) {
@@ -340,15 +345,14 @@ bool load_party_v2(fs::path file_to_load, cUniverse& univ){
 				return false;
 			}
 			univ.town.readFrom(fin);
-			
-			// Read town maps
-			std::istream& fin2 = partyIn.getFile("save/townmaps.dat");
-			for(int i = 0; i < 200; i++)
-				for(int j = 0; j < 8; j++)
-					for(int k = 0; k < 64; k++)
-						univ.town_maps[i][j][k] = fin2.get();
 		} else univ.town.num = 200;
 		
+		// Read town maps; older saves have a fixed-size file, and only when saved in town
+		if(partyIn.hasFile("save/townmaps.txt"))
+			univ.town_maps.readFrom(partyIn.getFile("save/townmaps.txt"));
+		else if(partyIn.hasFile("save/townmaps.dat"))
+			univ.town_maps.readLegacy(partyIn.getFile("save/townmaps.dat"), 200);
+		
 		// Load outdoors data
 		std::istream& fin = partyIn.getFile("save/out.txt");
 		if(!fin) {
@@ -358,11 +362,10 @@ bool load_party_v2(fs::path file_to_load, cUniverse& univ){
 		univ.out.readFrom(fin);
 		
 		// Read outdoor maps
-		std::istream& fin2 = partyIn.getFile("save/outmaps.dat");
-		for(int i = 0; i < 100; i++)
-			for(int j = 0; j < 6; j++)
-				for(int k = 0; k < 48; k++)
-					univ.out_maps[i][j][k] = fin2.get();
+		if(partyIn.hasFile("save/outmaps.txt"))
+			univ.out_maps.readFrom(partyIn.getFile("save/outmaps.txt"));
+		else if(partyIn.hasFile("save/outmaps.dat"))
+			univ.out_maps.readLegacy(partyIn.getFile("save/outmaps.dat"), 100);
 	} else univ.party.scen_name = "";
 	
 	if(partyIn.hasFile("save/export.png")) {
@@ -392,6 +395,7 @@ bool save_party(fs::path dest_file, const cUniverse& univ) {
 	
 	// First, write the main party data
 	univ.party.writeTo(partyOut.newFile("save/party.txt"));
+	write_random_state(partyOut.newFile("save/random.txt"));
 	{
 		std::ostream& fout = partyOut.newFile("save/setup.dat");
 		static uint16_t magic = 0x0B0E;
@@ -420,24 +424,18 @@ bool save_party(fs::path dest_file, const cUniverse& univ) {
 		if(univ.town.num < 200) {
 			// Write the current town data
 			univ.town.writeTo(partyOut.newFile("save/town.txt"));
-			
-			// Write the town map data
-			std::ostream& fout = partyOut.newFile("save/townmaps.dat");
-			for(int i = 0; i < 200; i++)
-				for(int j = 0; j < 8; j++)
-					for(int k = 0; k < 64; k++)
-						fout.put(univ.town_maps[i][j][k]);
 		}
 		
+		// Write the town map data, for the towns that have been explored
+		if(univ.town_maps.size())
+			univ.town_maps.writeTo(partyOut.newFile("save/townmaps.txt"));
+		
 		// Write the current outdoors data
 		univ.out.writeTo(partyOut.newFile("save/out.txt"));
 		
-		// Write the outdoors map data
-		std::ostream& fout = partyOut.newFile("save/outmaps.dat");
-		for(int i = 0; i < 100; i++)
-			for(int j = 0; j < 6; j++)
-				for(int k = 0; k < 48; k++)
-					fout.put(univ.out_maps[i][j][k]);
+		// Write the outdoors map data, likewise
+		if(univ.out_maps.size())
+			univ.out_maps.writeTo(partyOut.newFile("save/outmaps.txt"));
 	}
 	
 	if(spec_scen_g.party_sheet) {
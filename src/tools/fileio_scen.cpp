@@ -56,6 +56,20 @@ static std::string get_file_error() {
 	return sout.str();
 }
 
+// Works out what the game needs to run each special node; see cSpecial::compile.
+static void compile_specials(cScenario& scenario) {
+	for(cSpecial& spec : scenario.scen_specials)
+		spec.compile();
+	for(cOutdoors* out : scenario.outdoors) {
+		for(cSpecial& spec : out->specials)
+			spec.compile();
+	}
+	for(cTown* town : scenario.towns) {
+		for(cSpecial& spec : town->specials)
+			spec.compile();
+	}
+}
+
 bool load_scenario(fs::path file_to_load, cScenario& scenario, bool only_header) {
 	// Before loading a scenario, we may need to pop scenario resource paths.
 	fs::path graphics_path = ResMgr::popPath<ImageRsrc>();
@@ -80,16 +94,22 @@ bool load_scenario(fs::path file_to_load, cScenario& scenario, bool only_header)
 		showError("That is not a Blades of Exile scenario.");
 		return false;
 	}  else try {
+		bool loaded;
 		if(fname.substr(dot) == ".boes")
-			return load_scenario_v2(file_to_load, scenario, only_header);
+			loaded = load_scenario_v2(file_to_load, scenario, only_header);
 		else if(fname.substr(dot) == ".exs")
-			return load_scenario_v1(file_to_load, scenario, only_header);
+			loaded = load_scenario_v1(file_to_load, scenario, only_header);
+		else {
+			showError("That is not a Blades of Exile scenario.");
+			return false;
+		}
+		if(loaded && !only_header)
+			compile_specials(scenario);
+		return loaded;
 	} catch(std::exception& x) {
 		showError("There was an error loading the scenario. The details of the error are given below; you may be able to decompress the scenario package, fix the error, and repack it.", x.what());
 		return false;
 	}
-	showError("That is not a Blades of Exile scenario.");
-	return false;
 }
 
 template<typename Container> static void port_shop_spec_node(cSpecial& spec, std::vector<shop_info_t>& shops, Container strs) {
@@ -1380,6 +1400,7 @@ void readMonstersFromXml(ticpp::Document&& data, cScenario& scenario) {
 				for(abil = abil.begin(monst.Get()); abil != abil.end(); abil++) {
 					readMonstAbilFromXml(*abil, the_mon);
 				}
+				the_mon.planTurn();
 			} else if(type == "attacks") {
 				int num_attacks = 0;
 				Iterator<Element> atk;
@@ -15,18 +15,20 @@
 #ifdef _WIN32
 #include <windows.h>
 #endif
-#include <GL/GL.h>
+#include <GL/gl.h>
 #endif
 
 #include <iostream>
 #include <typeinfo>
 #include <unordered_map>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/math/constants/constants.hpp>
 
 #include "restypes.hpp"
 #include "mathutil.hpp"
 #include "fileio.hpp"
+#include "lrucache.hpp"
 
 using boost::math::constants::pi;
 
@@ -160,21 +162,114 @@ void rect_draw_some_item(const sf::Texture& src_gworld,rectangle src_rect,const
 	rect_draw_some_item(src.getTexture(), dest_rect, targ_gworld, targ_rect, &maskShader);
 }
 
-void TextStyle::applyTo(sf::Text& text) {
+static bool overlaps(const rectangle& a, const rectangle& b) {
+	return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+void cSpriteBatch::begin(sf::RenderTarget& targ) {
+	if(target) end();
+	target = &targ;
+	drawn.clear();
+}
+
+cSpriteBatch::run_t& cSpriteBatch::findRun(const sf::Texture* texture, sf::BlendMode mode, rectangle dest) {
+	for(size_t i = runs.size(); i > 0; i--) {
+		run_t& run = runs[i - 1];
+		if(run.texture == texture && run.mode == mode && !run.mask)
+			return run;
+		if(std::any_of(run.dests.begin(), run.dests.end(), [&dest](const rectangle& r) {return overlaps(r, dest);}))
+			break;
+	}
+	runs.push_back({texture, nullptr, mode, sf::VertexArray(sf::Triangles)});
+	return runs.back();
+}
+
+void cSpriteBatch::draw(const sf::Texture& src, rectangle src_rect, sf::RenderTarget& targ, rectangle dest, sf::BlendMode mode) {
+	if(&targ != target) {
+		rect_draw_some_item(src, src_rect, targ, dest, mode);
+		return;
+	}
+	run_t& run = findRun(&src, mode, dest);
+	// Place it just as sf::Sprite would, so that it lands on exactly the same pixels
+	sf::Sprite tile(src, src_rect);
+	tile.setPosition(dest.left, dest.top);
+	double xScale = dest.width(), yScale = dest.height();
+	xScale /= src_rect.width();
+	yScale /= src_rect.height();
+	tile.setScale(xScale, yScale);
+	const sf::Transform& xf = tile.getTransform();
+	float w = src_rect.width(), h = src_rect.height();
+	float l = src_rect.left, t = src_rect.top, r = src_rect.right, b = src_rect.bottom;
+	sf::Vertex tl(xf.transformPoint(0, 0), sf::Vector2f(l, t)), bl(xf.transformPoint(0, h), sf::Vector2f(l, b));
+	sf::Vertex tr(xf.transformPoint(w, 0), sf::Vector2f(r, t)), br(xf.transformPoint(w, h), sf::Vector2f(r, b));
+	// The same two triangles as the sprite's strip
+	for(const sf::Vertex& v : {tl, bl, tr, bl, tr, br})
+		run.quads.append(v);
+	run.dests.push_back(dest);
+	drawn.push_back(dest);
+}
+
+void cSpriteBatch::drawMasked(const sf::Texture& src, rectangle src_rect, const sf::Texture& mask, sf::RenderTarget& targ, rectangle dest) {
+	if(&targ != target) {
+		rect_draw_some_item(src, src_rect, mask, targ, dest);
+		return;
+	}
+	runs.push_back({&src, &mask, sf::BlendNone, sf::VertexArray(), {dest}, src_rect});
+	drawn.push_back(dest);
+}
+
+void cSpriteBatch::fill(sf::RenderTarget& targ, rectangle dest, sf::Color colour) {
+	if(&targ != target) {
+		fill_rect(targ, dest, colour);
+		return;
+	}
+	run_t& run = findRun(nullptr, sf::BlendAlpha, dest);
+	sf::Vertex tl(sf::Vector2f(dest.left, dest.top), colour), bl(sf::Vector2f(dest.left, dest.bottom), colour);
+	sf::Vertex tr(sf::Vector2f(dest.right, dest.top), colour), br(sf::Vector2f(dest.right, dest.bottom), colour);
+	for(const sf::Vertex& v : {tl, bl, tr, bl, tr, br})
+		run.quads.append(v);
+	run.dests.push_back(dest);
+	drawn.push_back(dest);
+}
+
+void cSpriteBatch::end() {
+	if(!target) return;
+	setActiveRenderTarget(*target);
+	calls = 0;
+	for(run_t& run : runs) {
+		if(run.mask)
+			rect_draw_some_item(*run.texture, run.src_rect, *run.mask, *target, run.dests[0]);
+		else target->draw(run.quads, sf::RenderStates(run.mode, sf::Transform::Identity, run.texture, nullptr));
+		calls++;
+	}
+	runs.clear();
+	target = nullptr;
+}
+
+const std::vector<rectangle>& cSpriteBatch::drawnRects() const {
+	return drawn;
+}
+
+size_t cSpriteBatch::drawCalls() const {
+	return calls;
+}
+
+static std::shared_ptr<sf::Font> get_font(eFont font) {
 	switch(font) {
 		case FONT_PLAIN:
-			text.setFont(*ResMgr::get<FontRsrc>("plain"));
-			break;
+			return ResMgr::get<FontRsrc>("plain");
 		case FONT_BOLD:
-			text.setFont(*ResMgr::get<FontRsrc>("bold"));
-			break;
+			return ResMgr::get<FontRsrc>("bold");
 		case FONT_DUNGEON:
-			text.setFont(*ResMgr::get<FontRsrc>("dungeon"));
-			break;
+			return ResMgr::get<FontRsrc>("dungeon");
 		case FONT_MAIDWORD:
-			text.setFont(*ResMgr::get<FontRsrc>("maidenword"));
-			break;
+			return ResMgr::get<FontRsrc>("maidenword");
 	}
+	return ResMgr::get<FontRsrc>("bold");
+}
+
+void TextStyle::applyTo(sf::Text& text) {
+	text.setFont(*get_font(font));
 	text.setCharacterSize(pointSize);
 	int style = sf::Text::Regular;
 	if(italic) style |= sf::Text::Italic;
@@ -183,6 +278,21 @@ void TextStyle::applyTo(sf::Text& text) {
 	text.setColor(colour);
 }
 
+// Everything about the style that changes the shape of the text; the colour doesn't.
+static void style_key(std::string& key, const TextStyle& style) {
+	key += char(style.font);
+	key += char(style.italic | style.underline << 1);
+	key += std::to_string(style.pointSize) + ',' + std::to_string(style.lineHeight) + ',';
+}
+
+struct text_size_t {
+	std::shared_ptr<sf::Font> font; // Only good while this is still the font
+	size_t width;
+	short height;
+};
+
+static cLruCache<std::string,text_size_t> size_cache(1024);
+
 struct text_params_t {
 	TextStyle style;
 	eTextMode mode;
@@ -196,6 +306,21 @@ struct text_params_t {
 	std::vector<snippet_t> snippets;
 };
 
+// A string broken into snippets and laid out, relative to the corner of the rect plus the offset
+struct text_layout_t {
+	std::shared_ptr<sf::Font> font; // Only good while this is still the font
+	std::vector<snippet_t> snippets;
+	std::vector<sf::Text> text; // Each snippet, already positioned
+	std::vector<sf::FloatRect> bounds;
+};
+
+static cLruCache<std::string,text_layout_t> layout_cache(256);
+
+void clear_text_cache() {
+	size_cache.clear();
+	layout_cache.clear();
+}
+
 void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,text_params_t& options);
 
 void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,eTextMode mode,TextStyle style, location offset) {
@@ -268,8 +393,8 @@ static void push_snippets(size_t start, size_t end, text_params_t& options, size
 	} while(start < upper_bound);
 }
 
-void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,text_params_t& options) {
-	if(str.empty()) return; // Nothing to do!
+// Breaks the string into snippets and places them, leaving them in options.snippets
+static void layout_string(rectangle dest_rect,std::string str,text_params_t& options) {
 	short line_height = options.style.lineHeight;
 	sf::Text str_to_draw;
 	options.style.applyTo(str_to_draw);
@@ -285,9 +410,6 @@ void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::stri
 	
 	str_to_draw.setString(str);
 	str_len = str.length();
-	if(str_len == 0) {
-		return;
-	}
 	
 	eTextMode mode = options.mode;
 	total_width = str_to_draw.getLocalBounds().width;
@@ -346,12 +468,69 @@ void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::stri
 		}
 		push_snippets(0, str.length() + 1, options, iHilite, str, moveTo);
 	}
+}
+
+// The layout depends on the size of the rect but not where it is, so it's kept relative to the
+// corner and can be reused for the same string drawn elsewhere. Centred text also depends on
+// how the centre rounded, which goes in the key too.
+static text_layout_t& get_layout(rectangle dest_rect,const std::string& str,text_params_t& options) {
+	std::shared_ptr<sf::Font> font = get_font(options.style.font);
+	std::string key = str;
+	key += '\0';
+	style_key(key, options.style);
+	key += std::to_string(int(options.mode)) + ',' + std::to_string(options.showBreaks) + ',';
+	key += std::to_string(int(dest_rect.width())) + ',' + std::to_string(int(dest_rect.height()));
+	if(options.mode == eTextMode::CENTRE) {
+		short line_height = options.style.lineHeight - 2;
+		key += ',' + std::to_string((dest_rect.right + dest_rect.left) / 2 - dest_rect.left);
+		key += ',' + std::to_string((dest_rect.bottom + dest_rect.top - line_height) / 2 - dest_rect.top);
+	}
+	for(const hilite_t& hilite : options.hilite_ranges)
+		key += ',' + std::to_string(hilite.first) + '-' + std::to_string(hilite.second);
+	text_layout_t* found = layout_cache.find(key);
+	if(found && found->font == font)
+		return *found;
 	
-	for(auto& snippet : options.snippets) {
-		str_to_draw.setString(snippet.text);
-		str_to_draw.setPosition(snippet.at);
+	text_layout_t layout;
+	layout.font = font;
+	layout_string(dest_rect, str, options);
+	location corner(dest_rect.left + options.offset.x, dest_rect.top + options.offset.y);
+	for(snippet_t& snippet : options.snippets) {
+		snippet.at.x -= corner.x;
+		snippet.at.y -= corner.y;
+		sf::Text text;
+		options.style.applyTo(text);
+		text.setString(snippet.text);
+		text.setPosition(snippet.at);
+		layout.bounds.push_back(text.getGlobalBounds());
+		layout.text.push_back(text);
+	}
+	layout.snippets.swap(options.snippets);
+	return layout_cache.insert(key, std::move(layout));
+}
+
+void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,text_params_t& options) {
+	if(str.empty()) return; // Nothing to do!
+	// Nothing below touches the caches, so this stays valid while drawing.
+	text_layout_t& layout = get_layout(dest_rect, str, options);
+	location corner(dest_rect.left + options.offset.x, dest_rect.top + options.offset.y);
+	sf::RenderStates states;
+	states.transform.translate(corner.x, corner.y);
+	sf::RenderStates bold_states = states;
+	bold_states.transform.translate(1, 0);
+	
+	options.snippets.clear();
+	for(size_t i = 0; i < layout.snippets.size(); i++) {
+		snippet_t snippet = layout.snippets[i];
+		snippet.at.x += corner.x;
+		snippet.at.y += corner.y;
+		options.snippets.push_back(snippet);
+		sf::Text& str_to_draw = layout.text[i];
 		if(snippet.hilited) {
-			rectangle bounds = str_to_draw.getGlobalBounds();
+			sf::FloatRect global = layout.bounds[i];
+			global.left += corner.x;
+			global.top += corner.y;
+			rectangle bounds = global;
 			// Adjust so that drawing the same text to
 			// the same rect is positioned exactly right
 			bounds.left = snippet.at.x - 1;
@@ -362,23 +541,30 @@ void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::stri
 			bounds.inset(0,-4);
 			fill_rect(dest_window, bounds, options.hilite_bg);
 		} else str_to_draw.setColor(options.style.colour);
-		dest_window.draw(str_to_draw);
-		if(options.style.font == FONT_BOLD) {
-			str_to_draw.move(1, 0);
-			dest_window.draw(str_to_draw);
-		}
+		dest_window.draw(str_to_draw, states);
+		if(options.style.font == FONT_BOLD)
+			dest_window.draw(str_to_draw, bold_states);
 	}
 }
 
 size_t string_length(std::string str, TextStyle style, short* height){
-	size_t total_width = 0;
-	
-	sf::Text text;
-	style.applyTo(text);
-	text.setString(str);
-	total_width = text.getLocalBounds().width;
-	if(height) *height = text.getLocalBounds().height;
-	return total_width;
+	std::shared_ptr<sf::Font> font = get_font(style.font);
+	std::string key = str;
+	key += '\0';
+	style_key(key, style);
+	text_size_t* found = size_cache.find(key);
+	if(!found || found->font != font) {
+		sf::Text text;
+		style.applyTo(text);
+		text.setString(str);
+		text_size_t size;
+		size.font = font;
+		size.width = text.getLocalBounds().width;
+		size.height = text.getLocalBounds().height;
+		found = &size_cache.insert(key, size);
+	}
+	if(height) *height = found->height;
+	return found->width;
 }
 
 rectangle calc_rect(short i, short j){
@@ -856,6 +1042,39 @@ void fill_region(sf::RenderWindow& target, Region& region, sf::Color colour) {
 	undo_clip(target);
 }
 
+void make_dark_mask(const char (&lights)[13][13], sf::Image& mask) {
+	static const rectangle view = {13,13,337,265};
+	char light[13][13];
+	std::copy(&lights[0][0], &lights[0][0] + 13 * 13, &light[0][0]);
+	mask.create(view.width(), view.height(), sf::Color::Black);
+	auto light_up = [&mask](int left, int top, int width, int height, bool oval) {
+		left -= view.left;
+		top -= view.top;
+		double rx = width / 2.0, ry = height / 2.0;
+		for(int y = std::max(top, 0); y < std::min(top + height, int(mask.getSize().y)); y++)
+			for(int x = std::max(left, 0); x < std::min(left + width, int(mask.getSize().x)); x++) {
+				if(oval) {
+					// Test the centre of the pixel against the oval
+					double dx = (x + 0.5 - left - rx) / rx, dy = (y + 0.5 - top - ry) / ry;
+					if(dx * dx + dy * dy > 1) continue;
+				}
+				mask.setPixel(x, y, sf::Color::Transparent);
+			}
+	};
+	for(short i = 1; i < 12; i++)
+		for(short j = 1; j < 12; j++) {
+			if(light[i][j] == 2)
+				light_up(13 + 28 * (i - 3), 13 + 36 * (j - 3), 84, 108, true);
+			if(light[i][j] == 3) {
+				light_up(13 + 28 * (i - 2), 13 + 36 * (j - 2), 56, 72, false);
+				// One block covers the next two spaces over and down
+				if(light[i + 1][j] == 3) light[i + 1][j] = 0;
+				if(light[i + 1][j + 1] == 3) light[i + 1][j + 1] = 0;
+				if(light[i][j + 1] == 3) light[i][j + 1] = 0;
+			}
+		}
+}
+
 void Region::addEllipse(rectangle frame) {
 	EllipseShape* ellipse = new EllipseShape(sf::Vector2f(frame.width(), frame.height()));
 	ellipse->setFillColor(sf::Color::Black);
@@ -938,6 +1157,19 @@ void undo_clip(sf::RenderTarget& where) {
 	glDisable(GL_STENCIL_TEST);
 }
 
+bool wait_for_event(sf::Window& win, sf::Event& event, sf::Time timeout) {
+	// SFML can only wait on a window with no time limit, so nap between polls instead.
+	// It still leaves the CPU idle almost all of the time.
+	static const sf::Time nap = sf::milliseconds(5);
+	sf::Clock waited;
+	while(!win.pollEvent(event)) {
+		sf::Time left = timeout - waited.getElapsedTime();
+		if(left <= sf::Time::Zero) return false;
+		sf::sleep(std::min(left, nap));
+	}
+	return true;
+}
+
 void setActiveRenderTarget(sf::RenderTarget& where) {
 	const std::type_info& type = typeid(where);
 	if(type == typeid(sf::RenderWindow&))
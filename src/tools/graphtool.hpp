@@ -56,6 +56,36 @@ public:
 	rectangle getEnclosingRect();
 };
 
+// Collects sprites drawn to one target between begin() and end(), and draws them in as few calls as it can.
+// A sprite joins an earlier run with the same texture and blend mode unless something drawn since
+// overlaps it, so the result is exactly what drawing each in turn would give.
+// Anything drawn through it to another target, or while it isn't collecting, is drawn at once.
+class cSpriteBatch {
+	struct run_t {
+		const sf::Texture* texture; // Null for a solid fill
+		const sf::Texture* mask;
+		sf::BlendMode mode;
+		sf::VertexArray quads;
+		std::vector<rectangle> dests;
+		rectangle src_rect; // Only for a masked sprite, which is always a run of its own
+	};
+	sf::RenderTarget* target = nullptr;
+	std::vector<run_t> runs;
+	std::vector<rectangle> drawn;
+	size_t calls = 0;
+	run_t& findRun(const sf::Texture* texture, sf::BlendMode mode, rectangle dest);
+public:
+	void begin(sf::RenderTarget& targ);
+	void end();
+	void draw(const sf::Texture& src, rectangle src_rect, sf::RenderTarget& targ, rectangle dest, sf::BlendMode mode = sf::BlendNone);
+	void drawMasked(const sf::Texture& src, rectangle src_rect, const sf::Texture& mask, sf::RenderTarget& targ, rectangle dest);
+	void fill(sf::RenderTarget& targ, rectangle dest, sf::Color colour);
+	// Where each sprite collected since begin() goes, in the order they were drawn
+	const std::vector<rectangle>& drawnRects() const;
+	// How many draw calls the last end() made
+	size_t drawCalls() const;
+};
+
 static const pic_num_t NO_PIC = -1;
 using graf_pos = std::pair<sf::Texture*,rectangle>;
 using graf_pos_ref = std::pair<sf::Texture*&,rectangle&>;
@@ -114,8 +144,12 @@ std::vector<rectangle> draw_string_hilite(sf::RenderTarget& dest_window,rectangl
 std::vector<snippet_t> draw_string_sel(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,TextStyle style,std::vector<hilite_t> hilites,sf::Color hiliteClr);
 void win_draw_string(sf::RenderTarget& dest_window,rectangle dest_rect,std::string str,eTextMode mode,TextStyle style, location offset = {0,0});
 size_t string_length(std::string str, TextStyle style, short* height = nullptr);
+// Laid-out text is cached; this drops it all, such as for timing the layout.
+void clear_text_cache();
 rectangle calc_rect(short i, short j);
 void setActiveRenderTarget(sf::RenderTarget& where);
+// Waits up to the timeout for the next event on the window; false if none came.
+bool wait_for_event(sf::Window& win, sf::Event& event, sf::Time timeout);
 tessel_ref_t prepareForTiling(sf::Texture& srcImg, rectangle srcRect);
 void tileImage(sf::RenderTarget& target, rectangle area, tessel_ref_t tessel, sf::BlendMode mode = sf::BlendNone);
 void tileImage(sf::RenderWindow& target, Region& rgn, tessel_ref_t tessel, sf::BlendMode mode = sf::BlendNone);
@@ -126,6 +160,9 @@ void frame_circle(sf::RenderTarget& target, rectangle rect, sf::Color colour);
 void fill_roundrect(sf::RenderTarget& target, rectangle rect, int rad, sf::Color colour);
 void frame_roundrect(sf::RenderTarget& target, rectangle rect, int rad, sf::Color colour);
 void fill_region(sf::RenderWindow& target, Region& region, sf::Color colour);
+// The darkness over the terrain view for a light pattern: 2 lights an oval around the space, 3 a block.
+// The mask covers the view from its top left corner; black is dark and transparent is lit.
+void make_dark_mask(const char (&lights)[13][13], sf::Image& mask);
 void draw_line(sf::RenderTarget& target, location from, location to, int thickness, sf::Color colour, sf::BlendMode mode = sf::BlendNone);
 
 void clip_rect(sf::RenderTarget& where, rectangle rect);
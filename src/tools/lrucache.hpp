@@ -0,0 +1,51 @@
+//
+//  lrucache.hpp
+//  BoE
+//
+//  A small cache that keeps the most recently used entries.
+//
+
+#ifndef BoE_LRUCACHE_HPP
+#define BoE_LRUCACHE_HPP
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Keeps the most recently used entries, dropping the least recently used once full.
+template<typename Key, typename T> class cLruCache {
+	typedef std::list<std::pair<Key,T>> list_t;
+	list_t entries;
+	std::unordered_map<Key,typename list_t::iterator> index;
+	size_t capacity;
+public:
+	explicit cLruCache(size_t capacity) : capacity(capacity) {}
+	T* find(const Key& key) {
+		auto iter = index.find(key);
+		if(iter == index.end()) return nullptr;
+		entries.splice(entries.begin(), entries, iter->second);
+		return &iter->second->second;
+	}
+	T& insert(const Key& key, T value) {
+		auto iter = index.find(key);
+		if(iter != index.end()) {
+			entries.erase(iter->second);
+			index.erase(iter);
+		} else if(entries.size() >= capacity) {
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+		entries.emplace_front(key, std::move(value));
+		index[key] = entries.begin();
+		return entries.front().second;
+	}
+	size_t size() const {
+		return entries.size();
+	}
+	void clear() {
+		entries.clear();
+		index.clear();
+	}
+};
+
+#endif
@@ -6,21 +6,36 @@
  *
  */
 
-#include <cstdlib>
 #include "mathutil.hpp"
+#include "prng.hpp"
 
 short get_ran (short times,short  min,short  max){
-	long int store;
-	short i, to_ret = 0;
-	
-	if(max < min) max = min;
-	if(max == min) return times * min;
-	
-	for(i = 1; i < times + 1; i++) {
-		store = rand();
-		to_ret += min + (store % (max - min + 1));
+	return ran_stream().roll(times, min, max);
+}
+
+void get_ran(short* results, size_t count, short times, short min, short max) {
+	ran_stream().roll(results, count, times, min, max);
+}
+
+// Keeps each set bit of which independently with probability chance / out_of, drawing from the given stream.
+// When out_of is a power of two and chance is 1 or out_of - 1, this is done a word at a time.
+uint64_t get_ran_bits(uint64_t which, short chance, short out_of, eRandStream stream) {
+	if(which == 0 || chance <= 0) return 0;
+	if(chance >= out_of) return which;
+	cPrng& gen = ran_stream(stream);
+	if((out_of & (out_of - 1)) == 0 && (chance == 1 || chance == out_of - 1)) {
+		uint64_t one_in = ~uint64_t(0);
+		for(short n = out_of; n > 1; n /= 2)
+			one_in &= gen.next();
+		return which & (chance == 1 ? one_in : ~one_in);
+	}
+	uint64_t kept = 0;
+	for(uint64_t w = which; w; w &= w - 1) {
+		uint64_t low = w & (~w + 1);
+		if(gen.below(out_of) < chance)
+			kept |= low;
 	}
-	return to_ret;
+	return kept;
 }
 
 short max(short a,short b){
@@ -7,10 +7,17 @@
  */
 
 #include <cmath>
+#include <cstdint>
+#include <cstddef>
 #include <SFML/System/Time.hpp>
 
+enum class eRandStream;
+
 using std::abs;
 short get_ran (short times,short  min,short  max);
+// Rolls the same dice count times, into results
+void get_ran(short* results, size_t count, short times, short min, short max);
+uint64_t get_ran_bits(uint64_t which, short chance, short out_of, eRandStream stream);
 short max(short a,short b);
 short min(short a,short b);
 short minmax(short min,short max,short k);
@@ -36,7 +43,8 @@ void erase_if(ContainerT& items, const PredicateT& predicate) {
 };
 
 // Case-insensitive string comparison seems to be semi-standard, but with different names.
-#if defined(__APPLE__)
+#if defined(__APPLE__) || defined(__unix__)
+#include <strings.h>
 #define strnicmp strncasecmp
 #elif defined(_MSC_VER)
 #define strnicmp _strnicmp
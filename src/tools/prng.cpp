@@ -0,0 +1,147 @@
+//
+//  prng.cpp
+//  BoE
+//
+//  The game's random number generator.
+//
+
+#include "prng.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static const int NUM_STREAMS = int(eRandStream::ANIM) + 1;
+
+static uint64_t splitmix64(uint64_t& x) {
+	uint64_t z = (x += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+cPrng::cPrng(uint64_t seed) {
+	this->seed(seed);
+}
+
+void cPrng::seed(uint64_t seed) {
+	for(int i = 0; i < 4; i++)
+		s[i] = splitmix64(seed);
+}
+
+uint64_t cPrng::next() {
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+// Lemire's multiply-and-reject; almost never needs more than one draw.
+uint32_t cPrng::below(uint32_t n) {
+	uint64_t m = (next() >> 32) * n;
+	uint32_t low = uint32_t(m);
+	if(low < n) {
+		uint32_t threshold = uint32_t(-n) % n;
+		while(low < threshold) {
+			m = (next() >> 32) * n;
+			low = uint32_t(m);
+		}
+	}
+	return m >> 32;
+}
+
+short cPrng::roll(short times, short min, short max) {
+	if(max < min) max = min;
+	if(max == min) return times * min;
+	uint32_t sides = max - min + 1;
+	short total = 0;
+	for(short i = 0; i < times; i++)
+		total += min + below(sides);
+	return total;
+}
+
+void cPrng::roll(short* results, size_t count, short times, short min, short max) {
+	if(max < min) max = min;
+	if(max == min) {
+		std::fill(results, results + count, times * min);
+		return;
+	}
+	uint32_t sides = max - min + 1;
+	for(size_t n = 0; n < count; n++) {
+		short total = 0;
+		for(short i = 0; i < times; i++)
+			total += min + below(sides);
+		results[n] = total;
+	}
+}
+
+void cPrng::writeTo(std::ostream& file) const {
+	file << s[0] << ' ' << s[1] << ' ' << s[2] << ' ' << s[3];
+}
+
+void cPrng::readFrom(std::istream& file) {
+	file >> s[0] >> s[1] >> s[2] >> s[3];
+}
+
+static uint64_t master_seed = 0;
+static cPrng streams[NUM_STREAMS];
+static eRandStream cur_stream = eRandStream::COMBAT;
+
+cPrng& ran_stream(eRandStream which) {
+	return streams[int(which)];
+}
+
+cPrng& ran_stream() {
+	return streams[int(cur_stream)];
+}
+
+eRandStream set_ran_stream(eRandStream which) {
+	eRandStream prev = cur_stream;
+	cur_stream = which;
+	return prev;
+}
+
+void seed_random(uint64_t seed) {
+	master_seed = seed;
+	for(int i = 0; i < NUM_STREAMS; i++) {
+		uint64_t x = seed + i;
+		streams[i].seed(splitmix64(x));
+	}
+}
+
+void write_random_state(std::ostream& file) {
+	file << "SEED " << master_seed << '\n';
+	for(int i = 0; i < NUM_STREAMS; i++) {
+		file << "STREAM " << i << ' ';
+		streams[i].writeTo(file);
+		file << '\n';
+	}
+}
+
+void read_random_state(std::istream& file) {
+	std::string cur;
+	while(getline(file, cur)) {
+		std::istringstream line(cur);
+		line >> cur;
+		if(cur == "SEED") {
+			uint64_t seed;
+			if(line >> seed)
+				seed_random(seed);
+		} else if(cur == "STREAM") {
+			int i;
+			line >> i;
+			if(i >= 0 && i < NUM_STREAMS)
+				streams[i].readFrom(line);
+		}
+	}
+}
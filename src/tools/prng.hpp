@@ -0,0 +1,55 @@
+//
+//  prng.hpp
+//  BoE
+//
+//  The game's random number generator.
+//
+
+#ifndef BoE_PRNG_HPP
+#define BoE_PRNG_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+// Each kind of randomness draws from its own stream, so that (for example) how many fields
+// happen to be decaying doesn't change what the next loot roll will be.
+enum class eRandStream {
+	COMBAT, // Also the default for anything not listed below
+	LOOT,
+	AI,
+	FIELDS,
+	ANIM, // Only for how things look, so that whether they're drawn doesn't change the game
+};
+
+// xoshiro256**, seeded through splitmix64.
+// Small, fast, and its state can be saved and restored exactly.
+class cPrng {
+	uint64_t s[4];
+public:
+	explicit cPrng(uint64_t seed = 0);
+	void seed(uint64_t seed);
+	uint64_t next();
+	// A uniform value in [0, n), without modulo bias
+	uint32_t below(uint32_t n);
+	// Sum of times rolls of a die numbered min..max
+	short roll(short times, short min, short max);
+	// The same, count times over; the dice are only set up once.
+	void roll(short* results, size_t count, short times, short min, short max);
+	void writeTo(std::ostream& file) const;
+	void readFrom(std::istream& file);
+};
+
+cPrng& ran_stream(eRandStream which);
+// The stream currently selected for get_ran
+cPrng& ran_stream();
+// Selects the stream used by get_ran; returns the previously selected one.
+eRandStream set_ran_stream(eRandStream which);
+// Reseeds every stream from one master seed.
+void seed_random(uint64_t seed);
+
+// The seed and the exact position of every stream, for saved games.
+void write_random_state(std::ostream& file);
+void read_random_state(std::istream& file);
+
+#endif
@@ -11,17 +11,49 @@
 #include <cstdio>
 #include <sstream>
 #include <memory>
+#include <vector>
+#include <iostream>
+#include <set>
+#include <stack>
 #include <unordered_set>
 #include <unordered_map>
+#include <boost/thread.hpp>
 
 #include "restypes.hpp"
 #include "mathutil.hpp"
 #include "prefs.hpp"
 
-std::shared_ptr<sf::Sound> chan[4];
-const int numchannel = 4;
-int channel;
-short snd_played[4];
+namespace fs = boost::filesystem;
+
+// One voice of the channel pool
+struct sound_channel_t {
+	sf::Sound sound;
+	snd_num_t which = -1;
+	eSndPriority priority = eSndPriority::LOW;
+	unsigned long started = 0; // Order the sounds were started in, to pick the oldest to cut off
+	std::function<void()> done;
+};
+static std::vector<sound_channel_t> channels;
+static unsigned long sounds_started = 0;
+// Callbacks of sounds that ended, waiting for update_sounds to run them
+static std::vector<std::function<void()>> finished;
+
+// A batch of sounds being decoded in the background by preload_sounds
+struct sound_bank_t {
+	struct entry_t {
+		std::string name;
+		fs::path path;
+		std::shared_ptr<sf::SoundBuffer> buffer;
+	};
+	std::vector<entry_t> todo;
+	size_t budget = 0, used = 0;
+	boost::mutex lock;
+	// These are guarded by the lock
+	std::vector<entry_t> ready;
+	bool cancelled = false, done = false;
+};
+static std::shared_ptr<sound_bank_t> sound_bank;
+static boost::thread bank_thread;
 
 short last_played;
 std::unordered_set<int> always_async = {
@@ -37,13 +69,12 @@ std::unordered_map<int,int> sound_delay = {
 	{44,20},{61,13}
 };
 short store_last_sound_played;
+static bool muted = false;
 
 bool sound_going(snd_num_t which_s) {
-	short i;
-	
-	for(i = 0; i < 4; i++)
-		if(snd_played[i] == which_s)
-			return chan[i]->getStatus() == sf::Sound::Playing;
+	for(const sound_channel_t& ch : channels)
+		if(ch.which == which_s && ch.sound.getStatus() == sf::Sound::Playing)
+			return true;
 	return false;
 }
 
@@ -53,17 +84,57 @@ static std::string sound_to_fname_map(snd_num_t snd_num) {
 	return sout.str();
 }
 
+// Stops the bank if it's still going, waiting for it to finish the sound it's on
+static void stop_sound_bank() {
+	if(sound_bank) {
+		boost::lock_guard<boost::mutex> guard(sound_bank->lock);
+		sound_bank->cancelled = true;
+	}
+	if(bank_thread.joinable())
+		bank_thread.join();
+	sound_bank.reset();
+}
+
 static void exit_snd_tool() {
-	for(auto& ch : chan) ch.reset();
+	stop_sound_bank();
+	channels.clear();
 }
 
 void init_snd_tool(){
-	for(auto& ch : chan) ch.reset(new sf::Sound);
+	channels.clear();
+	channels.resize(minmax(1, 32, get_int_pref("SoundChannels", 8)));
 	ResMgr::setIdMapFn<SoundRsrc>(sound_to_fname_map);
 	atexit(exit_snd_tool);
 }
 
-void play_sound(short which, sf::Time delay) { // if < 0, play asynch
+// Frees the channel, queueing its callback if it had one
+static void release_channel(sound_channel_t& ch) {
+	ch.sound.stop();
+	ch.which = -1;
+	if(ch.done) {
+		finished.push_back(std::move(ch.done));
+		ch.done = nullptr;
+	}
+}
+
+static sound_channel_t* find_channel(eSndPriority priority) {
+	sound_channel_t* victim = nullptr;
+	for(sound_channel_t& ch : channels) {
+		if(ch.sound.getStatus() != sf::Sound::Playing) {
+			release_channel(ch);
+			return &ch;
+		}
+		if(ch.priority > priority)
+			continue;
+		if(victim == nullptr || ch.priority < victim->priority || (ch.priority == victim->priority && ch.started < victim->started))
+			victim = &ch;
+	}
+	if(victim != nullptr)
+		release_channel(*victim);
+	return victim;
+}
+
+static void start_sound(short which, eSndPriority priority, std::function<void()> done) {
 	static bool inited = false;
 	if(!inited) {
 		inited = true;
@@ -71,39 +142,163 @@ void play_sound(short which, sf::Time delay) { // if < 0, play asynch
 	}
 	
 	std::shared_ptr<sf::SoundBuffer> sndhandle;
-	if(!get_bool_pref("PlaySounds", true)) {
-		if(which >= 0)
-			sf::sleep(delay);
+	sound_channel_t* ch = nullptr;
+	if(abs(which) >= 100 && !ResMgr::have<SoundRsrc>(abs(which)))
+		std::cerr << "Error: Sound #" << abs(which) << " does not exist." << std::endl;
+	else sndhandle = ResMgr::get<SoundRsrc>(abs(which));
+	if(sndhandle)
+		ch = find_channel(priority);
+	if(ch == nullptr) {
+		if(done) finished.push_back(std::move(done));
 		return;
 	}
-	
-	if(abs(which) >= 100 && !ResMgr::have<SoundRsrc>(abs(which))) {
-		std::cerr << "Error: Sound #" << abs(which) << " does not exist." << std::endl;
+	ch->sound.setBuffer(*sndhandle);
+	ch->sound.play();
+	ch->which = abs(which);
+	ch->priority = priority;
+	ch->started = ++sounds_started;
+	ch->done = std::move(done);
+}
+
+void play_sound(short which, eSndPriority priority, std::function<void()> done) {
+	if(muted || !get_bool_pref("PlaySounds", true) || channels.empty()) {
+		if(done) finished.push_back(std::move(done));
 		return;
 	}
-	
-	channel++;
-	
-	if(channel >= numchannel) channel = 0;
-	
-	if(!sound_going(abs(which)))
-		sndhandle = ResMgr::get<SoundRsrc>(abs(which));
-	
+	start_sound(which, priority, std::move(done));
+}
+
+void play_sound(short which) { // if < 0, play asynch
+	if(muted) return;
 	if(which > 0)
  		if(always_async.find(which) != always_async.end())
 			which *= -1;
 	
- 	if(sndhandle) {
-		chan[channel]->setBuffer(*sndhandle);
-		chan[channel]->play();
-		
-		if(which > 0) {
-			while(chan[channel]->getStatus() == sf::Sound::Playing);
+	if(get_bool_pref("PlaySounds", true) && !channels.empty())
+		start_sound(which, which < 0 ? eSndPriority::LOW : eSndPriority::NORMAL, nullptr);
+	// Nothing waits for the sound itself, but these few set the pace of their animations.
+	if(which < 0 && sound_delay.count(-which))
+		sf::sleep(time_in_ticks(sound_delay[-which]));
+}
+
+static void load_sound_bank(std::shared_ptr<sound_bank_t> bank) {
+	for(auto& entry : bank->todo) {
+		{
+			boost::lock_guard<boost::mutex> guard(bank->lock);
+			if(bank->cancelled) return;
+		}
+		// A WAV file is hardly any bigger than the samples it decodes to
+		boost::system::error_code err;
+		size_t size = fs::file_size(entry.path, err);
+		if(err || bank->used + size > bank->budget)
+			continue;
+		entry.buffer.reset(new sf::SoundBuffer);
+		if(!entry.buffer->loadFromFile(entry.path.string()))
+			continue;
+		bank->used += entry.buffer->getSampleCount() * sizeof(sf::Int16);
+		boost::lock_guard<boost::mutex> guard(bank->lock);
+		bank->ready.push_back(std::move(entry));
+	}
+	boost::lock_guard<boost::mutex> guard(bank->lock);
+	bank->done = true;
+}
+
+// Like ResMgr's own lookup, but without recording the result,
+// so that a stale sound from the last scenario still gets noticed and reloaded.
+static fs::path resolve_sound(std::string name) {
+	std::stack<fs::path> paths = ResMgr::resPool<SoundRsrc>::resPaths();
+	for(; !paths.empty(); paths.pop()) {
+		fs::path path = paths.top()/(name + "." + ResMgr::resLoader<SoundRsrc>::file_ext);
+		if(fs::exists(path))
+			return path;
+	}
+	return fs::path();
+}
+
+void preload_sounds() {
+	stop_sound_bank();
+	int budget = get_int_pref("SoundBankBudget", 64);
+	if(budget <= 0 || channels.empty())
+		return;
+	
+	std::shared_ptr<sound_bank_t> bank(new sound_bank_t);
+	bank->budget = size_t(budget) * 1024 * 1024;
+	std::set<snd_num_t> which;
+	for(snd_num_t i = 0; i < 100; i++)
+		which.insert(i);
+	// Then whatever the scenario brings along; only its folders sit above the data folder.
+	std::stack<fs::path> paths = ResMgr::resPool<SoundRsrc>::resPaths();
+	for(; !paths.empty(); paths.pop()) {
+		if(!fs::is_directory(paths.top()))
+			continue;
+		for(fs::directory_iterator iter(paths.top()); iter != fs::directory_iterator(); iter++) {
+			std::string fname = iter->path().stem().string();
+			if(fname.size() > 3 && fname.compare(0, 3, "SND") == 0 && fname.find_first_not_of("0123456789", 3) == std::string::npos)
+				which.insert(std::stoi(fname.substr(3)));
 		}
-		snd_played[channel] = abs(which);
 	}
-	if(which < 0)
-		sf::sleep(time_in_ticks(sound_delay[-1 * which]));
+	for(snd_num_t i : which) {
+		std::string name = sound_to_fname_map(i);
+		fs::path path = resolve_sound(name);
+		if(path.empty())
+			continue;
+		auto& loaded = ResMgr::resPool<SoundRsrc>::resources();
+		auto& found = ResMgr::resPool<SoundRsrc>::pathFound();
+		if(loaded.count(name) && found.count(name) && found[name] == path)
+			continue;
+		bank->todo.push_back({name, path, nullptr});
+	}
+	if(bank->todo.empty())
+		return;
+	sound_bank = bank;
+	bank_thread = boost::thread(load_sound_bank, bank);
+}
+
+// Hands sounds the bank has finished decoding over to the resource manager
+static void install_sound_bank() {
+	if(!sound_bank) return;
+	std::vector<sound_bank_t::entry_t> ready;
+	bool done;
+	{
+		boost::lock_guard<boost::mutex> guard(sound_bank->lock);
+		ready.swap(sound_bank->ready);
+		done = sound_bank->done;
+	}
+	auto& loaded = ResMgr::resPool<SoundRsrc>::resources();
+	auto& found = ResMgr::resPool<SoundRsrc>::pathFound();
+	for(auto& entry : ready) {
+		// It may have been played, and so loaded, in the meantime; don't cut it off.
+		if(loaded.count(entry.name) && found.count(entry.name) && found[entry.name] == entry.path)
+			continue;
+		loaded[entry.name] = entry.buffer;
+		found[entry.name] = entry.path;
+	}
+	if(done)
+		stop_sound_bank();
+}
+
+bool sounds_pending() {
+	if(!finished.empty())
+		return true;
+	for(const sound_channel_t& ch : channels)
+		if(ch.done)
+			return true;
+	return false;
+}
+
+void update_sounds() {
+	install_sound_bank();
+	for(sound_channel_t& ch : channels)
+		if(ch.which >= 0 && ch.sound.getStatus() != sf::Sound::Playing)
+			release_channel(ch);
+	// A callback may well start another sound, which can add to the list
+	std::vector<std::function<void()>> run;
+	run.swap(finished);
+	for(auto& done : run)
+		done();
+}
+void mute_sounds(bool mute) {
+	muted = mute;
 }
 
 void one_sound(short which) {
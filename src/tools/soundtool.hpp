@@ -9,13 +9,39 @@
 #ifndef _SOUNDTOOL_H
 #define _SOUNDTOOL_H
 
+#include <functional>
 #include <SFML/Audio.hpp>
 
 typedef signed int snd_num_t;
+
+// When every channel is busy, a new sound takes the channel of the lowest-priority sound
+// playing (the oldest, if there's a tie), as long as that one's priority is no higher.
+enum class eSndPriority {LOW, NORMAL};
+
 void init_snd_tool();
 bool sound_going(snd_num_t which_s);
-void play_sound(short which, sf::Time delay = sf::Time());
+// Starts a sound and returns without waiting for it to finish.
+// A negative number marks a background sound, which has low priority.
+// The same sound can play on more than one channel at once.
+// Some sounds still hold the game for a moment so that animations keep their pace,
+// whether or not sound is turned on.
+void play_sound(short which);
+// As above, calling done once the sound finishes, is cut off, or can't be played at all.
+// The call always comes from update_sounds, never from within play_sound.
+void play_sound(short which, eSndPriority priority, std::function<void()> done);
+// Runs the callbacks of any sounds that have finished; call it from the event loop.
+// Dialogs don't call it, so a callback never runs while one is up.
+void update_sounds();
+// Whether a callback is still to run. The game holds the player's input until it has,
+// so that whatever waits on the sound comes before the next thing the player does.
+bool sounds_pending();
+// Decodes the preset sounds and the scenario's own sounds in the background, up to the
+// SoundBankBudget pref (in megabytes), so that the first time each one plays it doesn't stall.
+// Call it once the scenario's sounds folder is in place; update_sounds hands the sounds over.
+void preload_sounds();
 void one_sound(short which);
+// While muted, play_sound returns at once, without playing or waiting out the sound.
+void mute_sounds(bool mute);
 
 void clear_sound_memory();
 
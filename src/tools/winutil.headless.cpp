@@ -0,0 +1,72 @@
+#include "winutil.hpp"
+
+// For builds with no display, such as the combat simulator.
+// There are no windows to arrange and no one to pick a file, so everything here does as little as it can.
+
+char keyToChar(sf::Keyboard::Key, bool) {
+	return 0;
+}
+
+std::string get_os_version() {
+	return "Headless";
+}
+
+void makeFrontWindow(sf::Window&) {}
+
+void setWindowFloating(sf::Window&, bool) {}
+
+void init_fileio() {}
+
+fs::path nav_get_party() {
+	return "";
+}
+
+fs::path nav_put_party(fs::path) {
+	return "";
+}
+
+fs::path nav_get_scenario() {
+	return "";
+}
+
+fs::path nav_put_scenario(fs::path) {
+	return "";
+}
+
+fs::path nav_get_rsrc(std::initializer_list<std::string>) {
+	return "";
+}
+
+fs::path nav_put_rsrc(std::initializer_list<std::string>, fs::path) {
+	return "";
+}
+
+static std::string clipboard;
+
+void set_clipboard(std::string text) {
+	clipboard = text;
+}
+
+std::string get_clipboard() {
+	return clipboard;
+}
+
+void set_clipboard_img(sf::Image&) {}
+
+std::unique_ptr<sf::Image> get_clipboard_img() {
+	return nullptr;
+}
+
+void beep() {}
+
+void launchURL(std::string) {}
+
+void ModalSession::pumpEvents() {}
+
+ModalSession::ModalSession(sf::Window&, sf::Window& p) : session(nullptr), parent(&p) {}
+
+ModalSession::~ModalSession() {}
+
+int getMenubarHeight() {
+	return 0;
+}
@@ -13,3 +13,7 @@ cCustomGraphics spec_scen_g;
 location cur_out;
 short cur_town;
 cScenario scenario;
+
+// And this is the game's, for its timers
+#include "universe.hpp"
+cUniverse univ;
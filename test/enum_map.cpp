@@ -0,0 +1,52 @@
+//
+//  enum_map.cpp
+//  BoE
+//
+//  Checks the enum-indexed arrays that hold statuses, skills and the like.
+//
+
+#include "catch.hpp"
+#include "enum_map.hpp"
+#include "simpletypes.hpp"
+
+TEST_CASE("Enum-indexed arrays") {
+	enum_map<eStatus, short, int(eStatus::CHARM) + 1> status;
+	SECTION("Everything starts clear") {
+		CHECK(status.size() == 16);
+		CHECK_FALSE(status.any());
+		CHECK(status[eStatus::POISON] == 0);
+		CHECK(status[eStatus::CHARM] == 0);
+	}
+	SECTION("Setting and reading back") {
+		status[eStatus::POISON] = 4;
+		status[eStatus::CHARM] = -1;
+		CHECK(status[eStatus::POISON] == 4);
+		CHECK(status[eStatus::CHARM] == -1);
+		CHECK(status.any());
+		CHECK(status.nonzero() == ((1ul << int(eStatus::POISON)) | (1ul << int(eStatus::CHARM))));
+		status.clear();
+		CHECK_FALSE(status.any());
+	}
+	SECTION("Keys outside the enum's range") {
+		status[eStatus::MAIN] = 5;
+		CHECK(status[eStatus::MAIN] == 0);
+		CHECK_FALSE(status.any());
+		CHECK_THROWS_AS(status.at(eStatus::MAIN), std::out_of_range);
+	}
+	SECTION("Iterating visits every key in order") {
+		status[eStatus::ACID] = 2;
+		int next = 0;
+		for(auto entry : status) {
+			CHECK(int(entry.first) == next++);
+			CHECK(entry.second == (entry.first == eStatus::ACID ? 2 : 0));
+		}
+		CHECK(next == 16);
+	}
+	SECTION("Copies are independent") {
+		status[eStatus::WEBS] = 3;
+		auto copy = status;
+		copy[eStatus::WEBS] = 0;
+		CHECK(status[eStatus::WEBS] == 3);
+		CHECK_FALSE(copy.any());
+	}
+}
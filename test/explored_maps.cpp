@@ -0,0 +1,53 @@
+//
+//  explored_maps.cpp
+//  BoE
+//
+//  Checks saving and loading the party's explored town and outdoor maps.
+//
+
+#include <sstream>
+#include "catch.hpp"
+#include "universe.hpp"
+
+TEST_CASE("Storing explored maps") {
+	cExploredMaps<64> maps;
+	SECTION("Nothing explored") {
+		CHECK(maps.size() == 0);
+		CHECK_FALSE(maps.isExplored(3, 10, 20));
+		std::ostringstream file;
+		maps.writeTo(file);
+		CHECK(file.str().empty());
+	}
+	SECTION("Only explored towns take space") {
+		maps.explore(150, 10, 20);
+		maps.explore(3, 63, 0);
+		CHECK(maps.size() == 2);
+		CHECK(maps.isExplored(150, 10, 20));
+		CHECK_FALSE(maps.isExplored(150, 20, 10));
+		CHECK(maps.isExplored(3, 63, 0));
+		CHECK_FALSE(maps.isExplored(4, 63, 0));
+	}
+	SECTION("Saving and loading") {
+		maps.explore(150, 10, 20);
+		maps.explore(250, 0, 63);
+		std::stringstream file;
+		maps.writeTo(file);
+		cExploredMaps<64> loaded;
+		loaded.readFrom(file);
+		CHECK(loaded.size() == 2);
+		CHECK(loaded.isExplored(150, 10, 20));
+		CHECK(loaded.isExplored(250, 0, 63));
+		CHECK_FALSE(loaded.isExplored(250, 63, 0));
+	}
+	SECTION("Loading the old fixed-size format") {
+		std::string old(2 * 6 * 48, '\0');
+		// Space 9,5 of the second sector: bit 1 of byte [1][5]
+		old[6 * 48 + 48 + 5] = 2;
+		std::istringstream file(old);
+		cExploredMaps<48> out_maps;
+		out_maps.readLegacy(file, 2);
+		CHECK(out_maps.size() == 1);
+		CHECK(out_maps.isExplored(1, 9, 5));
+		CHECK_FALSE(out_maps.isExplored(0, 9, 5));
+	}
+}
@@ -66,7 +66,7 @@ TEST_CASE("Initialization sanity test for monster") {
 		CHECK(monst.abil.empty());
 		CHECK(monst.corpse_item == 0);
 		CHECK(monst.corpse_item_chance == 0);
-		CHECK(monst.resist.size() == 10);
+		CHECK(monst.resist.size() == 11);
 		CHECK(monst.resist[eDamageType::WEAPON] == 100);
 		CHECK(monst.resist[eDamageType::FIRE] == 100);
 		CHECK(monst.resist[eDamageType::POISON] == 100);
@@ -109,7 +109,7 @@ TEST_CASE("Initialization sanity test for monster") {
 	}
 	SECTION("Living base class") {
 		iLiving& base = who;
-		CHECK(base.status.empty());
+		CHECK_FALSE(base.status.any());
 		CHECK(base.ap == 0);
 		CHECK(base.direction == DIR_HERE);
 		CHECK(base.marked_damage == 0);
@@ -181,7 +181,7 @@ TEST_CASE("Construction sanity test for monster") {
 		CHECK(pop[0].morale == 50);
 		CHECK(pop[0].ap == 0);
 		CHECK(pop[0].direction == DIR_HERE);
-		CHECK(pop[0].status.size() == 0);
+		CHECK_FALSE(pop[0].status.any());
 		CHECK(pop[0].attitude == eAttitude::HOSTILE_B);
 		CHECK(pop[0].cur_loc == loc(10,10));
 		// Townsperson stuff
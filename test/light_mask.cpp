@@ -0,0 +1,53 @@
+//
+//  light_mask.cpp
+//  BoE
+//
+//  Checks the darkness masks built from light patterns.
+//
+
+#include <cstring>
+#include <SFML/Graphics/Image.hpp>
+#include "catch.hpp"
+#include "graphtool.hpp"
+
+static bool is_dark(const sf::Image& mask, int x, int y) {
+	return mask.getPixel(x, y) == sf::Color::Black;
+}
+
+TEST_CASE("Building darkness masks from light patterns") {
+	char lights[13][13];
+	memset(lights, 0, sizeof(lights));
+	sf::Image mask;
+	SECTION("With no light") {
+		make_dark_mask(lights, mask);
+		CHECK(mask.getSize() == sf::Vector2u(252, 324));
+		CHECK(is_dark(mask, 0, 0));
+		CHECK(is_dark(mask, 126, 162));
+		CHECK(is_dark(mask, 251, 323));
+	}
+	SECTION("A lit block") {
+		lights[5][5] = 3;
+		make_dark_mask(lights, mask);
+		CHECK_FALSE(is_dark(mask, 84, 108));
+		CHECK_FALSE(is_dark(mask, 139, 179));
+		CHECK(is_dark(mask, 83, 108));
+		CHECK(is_dark(mask, 140, 108));
+		CHECK(is_dark(mask, 84, 180));
+	}
+	SECTION("A lit oval") {
+		lights[6][6] = 2;
+		make_dark_mask(lights, mask);
+		CHECK_FALSE(is_dark(mask, 126, 162));
+		CHECK_FALSE(is_dark(mask, 126, 109));
+		CHECK_FALSE(is_dark(mask, 85, 162));
+		// The corners of the oval's box stay dark
+		CHECK(is_dark(mask, 84, 108));
+		CHECK(is_dark(mask, 167, 215));
+	}
+	SECTION("A block covers the blocks next to it") {
+		lights[5][5] = lights[6][5] = 3;
+		make_dark_mask(lights, mask);
+		CHECK_FALSE(is_dark(mask, 100, 120));
+		CHECK(is_dark(mask, 150, 120));
+	}
+}
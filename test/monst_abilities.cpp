@@ -0,0 +1,73 @@
+//
+//  monst_abilities.cpp
+//  BoE
+//
+//  Checks the monster ability table keeps the ordering and lookups of the map it replaced.
+//
+
+#include <vector>
+#include "catch.hpp"
+#include "monster.hpp"
+
+static std::vector<eMonstAbil> keys_of(const cMonstAbilities& abil) {
+	std::vector<eMonstAbil> keys;
+	for(auto& p : abil)
+		keys.push_back(p.first);
+	return keys;
+}
+
+TEST_CASE("Monster ability table") {
+	cMonstAbilities abil;
+	CHECK(abil.empty());
+	SECTION("Insertion keeps keys in order") {
+		abil[eMonstAbil::SUMMON].summon.chance = 5;
+		abil[eMonstAbil::STUN].active = true;
+		abil[eMonstAbil::RADIATE].radiate.chance = 20;
+		abil[eMonstAbil::MISSILE].missile.range = 8;
+		CHECK(abil.size() == 4);
+		std::vector<eMonstAbil> want = {eMonstAbil::MISSILE, eMonstAbil::STUN, eMonstAbil::RADIATE, eMonstAbil::SUMMON};
+		CHECK(keys_of(abil) == want);
+		// Values followed their keys when later ones shifted up
+		CHECK(abil[eMonstAbil::SUMMON].summon.chance == 5);
+		CHECK(abil[eMonstAbil::RADIATE].radiate.chance == 20);
+		CHECK(abil[eMonstAbil::MISSILE].missile.range == 8);
+		CHECK(abil.size() == 4);
+	}
+	SECTION("Only active abilities count as had") {
+		abil[eMonstAbil::STUN].active = false;
+		abil[eMonstAbil::KILL].active = true;
+		CHECK_FALSE(abil.has(eMonstAbil::STUN));
+		CHECK(abil.has(eMonstAbil::KILL));
+		CHECK_FALSE(abil.has(eMonstAbil::SPLITS));
+		CHECK(abil.find(eMonstAbil::STUN) != abil.end());
+		CHECK(abil.find(eMonstAbil::SPLITS) == abil.end());
+	}
+	SECTION("Reading a const table doesn't insert") {
+		const cMonstAbilities& view = abil;
+		CHECK_FALSE(view[eMonstAbil::KILL].active);
+		CHECK(abil.empty());
+	}
+	SECTION("Erasing keeps the rest in order and findable") {
+		abil[eMonstAbil::SUMMON].summon.chance = 5;
+		abil[eMonstAbil::STUN].active = true;
+		abil[eMonstAbil::RADIATE].radiate.chance = 20;
+		auto next = abil.erase(abil.find(eMonstAbil::STUN));
+		REQUIRE(next != abil.end());
+		CHECK(next->first == eMonstAbil::RADIATE);
+		std::vector<eMonstAbil> want = {eMonstAbil::RADIATE, eMonstAbil::SUMMON};
+		CHECK(keys_of(abil) == want);
+		CHECK(abil.find(eMonstAbil::STUN) == abil.end());
+		CHECK(abil.find(eMonstAbil::SUMMON)->second.summon.chance == 5);
+		// And it can go back in
+		abil[eMonstAbil::STUN].active = true;
+		want.insert(want.begin(), eMonstAbil::STUN);
+		CHECK(keys_of(abil) == want);
+		CHECK(abil.find(eMonstAbil::RADIATE)->second.radiate.chance == 20);
+	}
+	SECTION("Clearing") {
+		abil[eMonstAbil::STUN].active = true;
+		abil.clear();
+		CHECK(abil.empty());
+		CHECK(abil.find(eMonstAbil::STUN) == abil.end());
+	}
+}
@@ -244,6 +244,7 @@ TEST_CASE("Loading monster abilities") {
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.type == eMonstGen::TOUCH);
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.strength == 8);
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.odds == 600);
+			CHECK(scen.scen_monsters[1].turn_plan == PLAN_TOUCH);
 		}
 		SECTION("Minimal ranged ability") {
 			fin.open("files/monsters/abil_gen/minimal_range.xml");
@@ -256,6 +257,7 @@ TEST_CASE("Loading monster abilities") {
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.odds == 600);
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.pic == 2);
 			CHECK(scen.scen_monsters[1].abil[eMonstAbil::DRAIN_SP].gen.range == 10);
+			CHECK(scen.scen_monsters[1].turn_plan == PLAN_RANGED);
 		}
 		SECTION("With an extra value when not needed") {
 			fin.open("files/monsters/abil_gen/bad_extra.xml");
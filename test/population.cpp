@@ -0,0 +1,73 @@
+//
+//  population.cpp
+//  BoE
+//
+//  Checks that a town's population keeps track of which creatures are about as they change.
+//
+
+#include <set>
+#include "catch.hpp"
+#include "creatlist.hpp"
+
+TEST_CASE("Tracking which creatures are about") {
+	cPopulation monst;
+	monst.init(2);
+	monst.init(5);
+	std::set<size_t> want = {2, 5};
+	REQUIRE(monst.present() == want);
+	CHECK(monst.awake().empty());
+	SECTION("Waking and removing creatures") {
+		monst[5].active = 2;
+		CHECK(monst.present() == want);
+		want = {5};
+		CHECK(monst.awake() == want);
+		monst[5].active = 0;
+		want = {2};
+		CHECK(monst.present() == want);
+		CHECK(monst.awake().empty());
+	}
+	SECTION("Creatures keep being tracked after the list grows") {
+		monst.init(40);
+		monst[2].active = 2;
+		want = {2, 5, 40};
+		CHECK(monst.present() == want);
+		want = {2};
+		CHECK(monst.awake() == want);
+	}
+	SECTION("Setting creatures aside for a while") {
+		monst[2].active += 10;
+		CHECK(monst[2].active == 11);
+		CHECK(monst.present() == want);
+		monst[2].active -= 10;
+		CHECK(monst[2].active == 1);
+		CHECK(monst.present() == want);
+	}
+	SECTION("Replacing a creature outright") {
+		cCreature other;
+		other.active = 2;
+		monst[2] = other;
+		want = {2};
+		CHECK(monst.awake() == want);
+		CHECK(monst[2].active == 2);
+		// The loose creature was never part of the population
+		other.active = 0;
+		CHECK(monst.awake() == want);
+	}
+	SECTION("Copies keep track of their own creatures") {
+		cPopulation copy = monst;
+		copy[2].active = 0;
+		CHECK(monst.present() == want);
+		want = {5};
+		CHECK(copy.present() == want);
+		monst = copy;
+		CHECK(monst.present() == want);
+		monst[5].active = 2;
+		CHECK(monst.awake() == want);
+		CHECK(copy.awake().empty());
+	}
+	SECTION("Clearing") {
+		monst.clear();
+		CHECK(monst.present().empty());
+		CHECK(monst.size() == 0);
+	}
+}
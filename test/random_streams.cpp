@@ -0,0 +1,136 @@
+//
+//  random_streams.cpp
+//  BoE
+//
+//  Checks that the random streams are reproducible and independent of each other.
+//
+
+#include <sstream>
+#include "catch.hpp"
+#include "prng.hpp"
+#include "mathutil.hpp"
+
+TEST_CASE("Random number generator") {
+	SECTION("The same seed gives the same sequence") {
+		cPrng a(1234), b(1234);
+		for(int i = 0; i < 100; i++)
+			CHECK(a.next() == b.next());
+	}
+	SECTION("Different seeds give different sequences") {
+		cPrng a(1234), b(1235);
+		int same = 0;
+		for(int i = 0; i < 100; i++)
+			if(a.next() == b.next()) same++;
+		CHECK(same == 0);
+	}
+	SECTION("Rolls stay in range") {
+		cPrng gen(99);
+		for(int i = 0; i < 1000; i++) {
+			CHECK(gen.below(6) < 6);
+			short roll = gen.roll(3, 1, 6);
+			CHECK(roll >= 3);
+			CHECK(roll <= 18);
+		}
+		CHECK(gen.roll(4, 2, 2) == 8);
+		CHECK(gen.roll(2, 5, 1) == 10);
+	}
+	SECTION("Rolling in batches") {
+		cPrng batch(31), single(31);
+		short results[50];
+		batch.roll(results, 50, 2, 1, 8);
+		// The same draws as rolling one at a time
+		for(short roll : results) {
+			CHECK(roll == single.roll(2, 1, 8));
+			CHECK(roll >= 2);
+			CHECK(roll <= 16);
+		}
+		CHECK(batch.next() == single.next());
+		short fixed[4];
+		batch.roll(fixed, 4, 3, 2, 2);
+		for(short roll : fixed)
+			CHECK(roll == 6);
+		batch.roll(results, 0, 1, 1, 6);
+		CHECK(batch.next() == single.next());
+	}
+	SECTION("Saving and restoring a generator") {
+		cPrng gen(42);
+		gen.next();
+		std::stringstream state;
+		gen.writeTo(state);
+		cPrng copy;
+		copy.readFrom(state);
+		for(int i = 0; i < 10; i++)
+			CHECK(copy.next() == gen.next());
+	}
+}
+
+TEST_CASE("Random streams") {
+	SECTION("Seeding is deterministic") {
+		seed_random(77);
+		uint64_t first = ran_stream(eRandStream::COMBAT).next();
+		seed_random(77);
+		CHECK(ran_stream(eRandStream::COMBAT).next() == first);
+	}
+	SECTION("Drawing from one stream doesn't move another") {
+		seed_random(77);
+		uint64_t loot = ran_stream(eRandStream::LOOT).next();
+		seed_random(77);
+		for(int i = 0; i < 50; i++) {
+			ran_stream(eRandStream::FIELDS).next();
+			ran_stream(eRandStream::ANIM).next();
+		}
+		CHECK(ran_stream(eRandStream::LOOT).next() == loot);
+	}
+	SECTION("Streams don't share a sequence") {
+		seed_random(77);
+		CHECK(ran_stream(eRandStream::COMBAT).next() != ran_stream(eRandStream::LOOT).next());
+	}
+	SECTION("Selecting the current stream") {
+		eRandStream prev = set_ran_stream(eRandStream::AI);
+		CHECK(&ran_stream() == &ran_stream(eRandStream::AI));
+		CHECK(set_ran_stream(prev) == eRandStream::AI);
+	}
+	SECTION("Batched dice draw from the current stream") {
+		seed_random(12);
+		short want[10];
+		ran_stream(eRandStream::LOOT).roll(want, 10, 1, 1, 20);
+		seed_random(12);
+		eRandStream prev = set_ran_stream(eRandStream::LOOT);
+		short got[10];
+		get_ran(got, 10, 1, 1, 20);
+		set_ran_stream(prev);
+		for(int i = 0; i < 10; i++)
+			CHECK(got[i] == want[i]);
+	}
+	SECTION("Random bits draw only from the stream they're given") {
+		seed_random(9);
+		uint64_t fields = ran_stream(eRandStream::FIELDS).next();
+		seed_random(9);
+		get_ran_bits(~uint64_t(0), 1, 6, eRandStream::COMBAT);
+		get_ran_bits(~uint64_t(0), 1, 8, eRandStream::COMBAT);
+		CHECK(ran_stream(eRandStream::FIELDS).next() == fields);
+	}
+	SECTION("Random bits only keep bits that were set") {
+		seed_random(9);
+		uint64_t which = 0xf0f0f0f0f0f0f0f0;
+		CHECK(get_ran_bits(which, 0, 6, eRandStream::FIELDS) == 0);
+		CHECK(get_ran_bits(which, 6, 6, eRandStream::FIELDS) == which);
+		for(int i = 0; i < 20; i++) {
+			CHECK((get_ran_bits(which, 1, 8, eRandStream::FIELDS) & ~which) == 0);
+			CHECK((get_ran_bits(which, 4, 7, eRandStream::FIELDS) & ~which) == 0);
+		}
+		// With 7 in 8 odds on 32 bits, losing all of them is practically impossible
+		CHECK(get_ran_bits(which, 7, 8, eRandStream::FIELDS) != 0);
+	}
+	SECTION("Saving and restoring every stream") {
+		seed_random(5);
+		ran_stream(eRandStream::AI).next();
+		std::stringstream state;
+		write_random_state(state);
+		uint64_t combat = ran_stream(eRandStream::COMBAT).next(), ai = ran_stream(eRandStream::AI).next();
+		seed_random(6);
+		read_random_state(state);
+		CHECK(ran_stream(eRandStream::COMBAT).next() == combat);
+		CHECK(ran_stream(eRandStream::AI).next() == ai);
+	}
+}
@@ -0,0 +1,84 @@
+//
+//  spec_compile.cpp
+//  BoE
+//
+//  Checks what compiling a special node works out, and how its pointers are looked up.
+//
+
+#include "catch.hpp"
+#include "special.hpp"
+#include "universe.hpp"
+
+TEST_CASE("Compiling special nodes") {
+	cSpecial spec;
+	SECTION("Uncompiled nodes check every slot") {
+		CHECK(spec.ptr_slots == (1 << cSpecial::NUM_SLOTS) - 1);
+	}
+	SECTION("Slots are in the documented order") {
+		spec.sd1 = 1; spec.sd2 = 2; spec.m1 = 3; spec.m2 = 4; spec.m3 = 5; spec.pic = 6; spec.pictype = 7;
+		spec.ex1a = 8; spec.ex1b = 9; spec.ex1c = 10; spec.ex2a = 11; spec.ex2b = 12; spec.ex2c = 13; spec.jumpto = 14;
+		for(int i = 0; i < cSpecial::NUM_SLOTS; i++)
+			CHECK(spec.slot(i) == i + 1);
+	}
+	SECTION("Only slots of -10 or less are pointers") {
+		spec.type = eSpecType::SET_SDF;
+		spec.sd1 = -105;
+		spec.ex1a = -2;
+		spec.ex2c = -9;
+		spec.jumpto = -12;
+		spec.compile();
+		CHECK(spec.ptr_slots == ((1 << 0) | (1 << 13)));
+		CHECK(spec.category == eSpecCat::GENERAL);
+	}
+	SECTION("Nodes without pointers have none marked") {
+		spec.type = eSpecType::IF_SDF;
+		spec.sd1 = 4; spec.sd2 = 5;
+		spec.compile();
+		CHECK(spec.ptr_slots == 0);
+		CHECK(spec.category == eSpecCat::IF_THEN);
+	}
+	SECTION("Unknown node types compile as invalid") {
+		spec.type = eSpecType::INVALID;
+		spec.compile();
+		CHECK(spec.category == eSpecCat::INVALID);
+	}
+}
+
+TEST_CASE("Looking up special node pointers") {
+	cUniverse univ;
+	univ.party.force_ptr(12, 7);
+	univ.party.set_ptr(105, 20, 3);
+	univ.party.stuff_done[20][3] = 42;
+	cSpecial spec;
+	spec.sd1 = -105;
+	spec.ex1a = -2;
+	spec.jumpto = -12;
+	SECTION("Compiled nodes look up their marked slots") {
+		spec.compile();
+		spec.resolve_pointers(univ.party);
+		CHECK(spec.sd1 == 42);
+		CHECK(spec.jumpto == 7);
+		CHECK(spec.ex1a == -2);
+	}
+	SECTION("Uncompiled nodes look up any pointer") {
+		spec.m1 = -12;
+		spec.resolve_pointers(univ.party);
+		CHECK(spec.sd1 == 42);
+		CHECK(spec.m1 == 7);
+		CHECK(spec.jumpto == 7);
+		CHECK(spec.ex1a == -2);
+	}
+	SECTION("Compiled nodes leave unmarked slots alone") {
+		spec.compile();
+		spec.m1 = -12;
+		spec.resolve_pointers(univ.party);
+		CHECK(spec.m1 == -12);
+		CHECK(spec.sd1 == 42);
+	}
+	SECTION("Unset pointers read as zero") {
+		spec.sd1 = -150;
+		spec.compile();
+		spec.resolve_pointers(univ.party);
+		CHECK(spec.sd1 == 0);
+	}
+}
@@ -0,0 +1,62 @@
+//
+//  text_bench.cpp
+//  BoE
+//
+//  Times drawing text with and without the layout cache.
+//  This needs a display, so it only runs when asked for: boe_test "[bench]"
+//
+
+#include <iostream>
+#include <SFML/Graphics.hpp>
+#include "catch.hpp"
+#include "graphtool.hpp"
+#include "restypes.hpp"
+
+// Roughly what put_pc_screen draws for a full party
+static void draw_pc_pane(sf::RenderTarget& targ) {
+	static const char* names[6] = {"Jenneke", "Thissa", "Frrrrrr", "Adrianna", "Pirin", "Morlock"};
+	TextStyle style;
+	style.font = FONT_BOLD;
+	style.pointSize = 12;
+	style.lineHeight = 10;
+	rectangle label = {0, 4, 12, 60};
+	win_draw_string(targ, label, "Food:", eTextMode::WRAP, style);
+	label.offset(60, 0);
+	win_draw_string(targ, label, "Gold:", eTextMode::WRAP, style);
+	label.offset(60, 0);
+	win_draw_string(targ, label, "Party stats:", eTextMode::WRAP, style);
+	style.pointSize = 10;
+	for(int i = 0; i < 6; i++) {
+		rectangle row = {13 + 13 * i, 4, 26 + 13 * i, 90};
+		win_draw_string(targ, row, names[i], eTextMode::WRAP, style);
+		row.offset(90, 0);
+		win_draw_string(targ, row, "HP:" + std::to_string(20 + i * 7), eTextMode::WRAP, style);
+		row.offset(50, 0);
+		win_draw_string(targ, row, "SP:" + std::to_string(i * 3), eTextMode::WRAP, style);
+		row.offset(50, 0);
+		win_draw_string(targ, row, std::to_string(i + 1), eTextMode::CENTRE, style);
+	}
+	string_length("Party stats:", style);
+}
+
+TEST_CASE("Redrawing the PC stat pane", "[.][bench]") {
+	ResMgr::pushPath<FontRsrc>("../rsrc/fonts");
+	sf::RenderTexture targ;
+	REQUIRE(targ.create(271, 116));
+	const int passes = 2000;
+
+	sf::Clock timer;
+	for(int i = 0; i < passes; i++) {
+		clear_text_cache();
+		draw_pc_pane(targ);
+	}
+	sf::Time cold = timer.restart();
+	for(int i = 0; i < passes; i++)
+		draw_pc_pane(targ);
+	sf::Time warm = timer.getElapsedTime();
+
+	std::cout << passes << " redraws of the PC pane: " << cold.asMilliseconds() << "ms laying out each time, ";
+	std::cout << warm.asMilliseconds() << "ms from the cache" << std::endl;
+	CHECK(warm < cold);
+	ResMgr::popPath<FontRsrc>();
+}
@@ -0,0 +1,131 @@
+//
+//  timers.cpp
+//  BoE
+//
+//  Checks the order timers go off in, and that the party's timers survive saving and loading.
+//
+
+#include <sstream>
+#include "catch.hpp"
+#include "universe.hpp"
+#include "boe.timers.hpp"
+
+extern cUniverse univ;
+
+static std::vector<size_t> fire_timers(unsigned long from, unsigned long to, eTimerKind kind) {
+	std::vector<size_t> fired;
+	timer_event_t event;
+	prepare_timers(from, -1);
+	while(next_timer(from, to, event)) {
+		CHECK(event.kind == kind);
+		CHECK(event.when > from);
+		CHECK(event.when <= to);
+		fired.push_back(event.which);
+	}
+	return fired;
+}
+
+TEST_CASE("Timers going off") {
+	univ.party.age = 1000;
+	univ.party.party_event_timers.clear();
+	univ.party.quest_status.clear();
+	for(cTimer& timer : univ.scenario.scenario_timers)
+		timer = cTimer();
+	reset_timers();
+	SECTION("Timers at the same age go off quests first, then town, scenario and party") {
+		timer_event_t quest{50, eTimerKind::QUEST, 3, 0}, town{50, eTimerKind::TOWN, 0, 0};
+		timer_event_t scen{50, eTimerKind::SCENARIO, 0, 0}, party{50, eTimerKind::PARTY, 0, 0};
+		CHECK(town > quest);
+		CHECK(scen > town);
+		CHECK(party > scen);
+		CHECK_FALSE(quest > party);
+		timer_event_t earlier{49, eTimerKind::PARTY, 5, 0};
+		CHECK(quest > earlier);
+		timer_event_t same_kind{50, eTimerKind::PARTY, 1, 0};
+		CHECK(same_kind > party);
+	}
+	SECTION("Party timers go off in order of when they're due") {
+		univ.party.start_timer(50, 10, 0);
+		univ.party.start_timer(10, 11, 0);
+		univ.party.start_timer(30, 12, 0);
+		univ.party.start_timer(200, 13, 0);
+		std::vector<size_t> want = {1, 2, 0};
+		CHECK(fire_timers(1000, 1100, eTimerKind::PARTY) == want);
+		// The last one is still waiting
+		want = {3};
+		CHECK(fire_timers(1100, 1200, eTimerKind::PARTY) == want);
+	}
+	SECTION("Reloading drops what was there before") {
+		univ.party.start_timer(10, 10, 0);
+		univ.party.start_timer(20, 11, 0);
+		prepare_timers(1000, -1);
+		univ.party.party_event_timers[0].node = -1;
+		reload_timers(eTimerKind::PARTY);
+		std::vector<size_t> want = {1};
+		CHECK(fire_timers(1000, 1100, eTimerKind::PARTY) == want);
+	}
+	SECTION("Scenario timers go off once each period") {
+		univ.scenario.scenario_timers[2].time = 25;
+		univ.scenario.scenario_timers[2].node = 7;
+		std::vector<size_t> want = {2, 2, 2, 2};
+		CHECK(fire_timers(1000, 1100, eTimerKind::SCENARIO) == want);
+		want = {2};
+		CHECK(fire_timers(1100, 1125, eTimerKind::SCENARIO) == want);
+	}
+	SECTION("A quest given as an item keeps its deadline") {
+		univ.scenario.quests.resize(4);
+		univ.scenario.quests[3].deadline = 2;
+		univ.scenario.quests[3].event = 0;
+		prepare_timers(1000, -1);
+		cPlayer::quests_changed = []() {
+			reload_timers(eTimerKind::QUEST);
+		};
+		cItem quest;
+		quest.variety = eItemType::QUEST;
+		quest.item_level = 3;
+		CHECK(univ.party[0].give_item(quest, 0));
+		cPlayer::quests_changed = nullptr;
+		// It's due at the start of day 3
+		CHECK(fire_timers(1000, 7399, eTimerKind::QUEST).empty());
+		std::vector<size_t> want = {3};
+		CHECK(fire_timers(7399, 7400, eTimerKind::QUEST) == want);
+	}
+	SECTION("Shifting the age keeps the party's timers as far off") {
+		univ.party.start_timer(40, 10, 0);
+		univ.party.shift_age(3700);
+		reset_timers();
+		CHECK(fire_timers(4700, 4739, eTimerKind::PARTY).empty());
+		std::vector<size_t> want = {0};
+		CHECK(fire_timers(4739, 4740, eTimerKind::PARTY) == want);
+	}
+}
+
+TEST_CASE("Saving and loading party timers") {
+	cUniverse saved_univ;
+	cParty& saved = saved_univ.party;
+	saved.age = 5000;
+	saved.start_timer(40, 10, 2);
+	saved.start_timer(300, 11, 0);
+	std::ostringstream file;
+	saved.writeTo(file);
+	SECTION("They keep the time they had left") {
+		cUniverse loaded_univ;
+		cParty& loaded = loaded_univ.party;
+		std::istringstream fin(file.str());
+		loaded.readFrom(fin);
+		CHECK(loaded.age == 5000);
+		REQUIRE(loaded.party_event_timers.size() == 2);
+		CHECK(loaded.party_event_timers[0].time == 5040);
+		CHECK(loaded.party_event_timers[0].node == 10);
+		CHECK(loaded.party_event_timers[0].node_type == 2);
+		CHECK(loaded.party_event_timers[1].time == 5300);
+		CHECK(loaded.party_event_timers[1].node == 11);
+	}
+	SECTION("Shifting the age doesn't change what's saved") {
+		saved.shift_age(-1000);
+		std::ostringstream shifted;
+		saved.writeTo(shifted);
+		CHECK(shifted.str().find("TIMER 0 40 2 10") != std::string::npos);
+		CHECK(shifted.str().find("TIMER 1 300 0 11") != std::string::npos);
+	}
+}